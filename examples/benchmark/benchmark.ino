@@ -0,0 +1,161 @@
+/**
+ * @file benchmark.ino
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Display and input throughput of Epson_PNL_CE02 library, printed as CSV to compare library revisions.
+ * Build it for the board (`pio run -e example_benchmark`) or for the simulator (`pio run -e native_benchmark`),
+ * where durations are the simulated bus time.
+ * @version 1.0
+ *
+ * @copyright MIT license
+ *
+ * Output:
+ *  => lines starting with '#' are comments
+ *  => `benchmark,ops,us_per_op,ops_per_s,bytes_per_s`, bytes are the payload of an operation (pixels in RGB565,
+ *     extender or buttons byte), not the bus overhead (commands, windows)
+ *
+ * | Pin | Purpose                                   | MEGA 2560     |
+ * |-----|-------------------------------------------|---------------|
+ * | 1   | 3-STATE Output Enable Input (OE)          | 45            |
+ * | 2   | Serial Data Output (SER OUT)              | 50 (SPI MISO) |
+ * | 3   | GND                                       | GND           |
+ * | 4   | Power button                              | 46 🔺         |
+ * | 5   | 3.3V supply                               | 3.3V          |
+ * | 6   | LCD reset (+3.3V !)                       | 47 ⚡         |
+ * | 7   | LCD backlight (+5V !)                     | 5V            |
+ * | 8   | GND                                       | -             |
+ * | 9   | Shift Register Clock Input (SCK)          | 52 (SPI SCK)  |
+ * | 10  | Serial Data Input (SER IN)                | 51 (SPI MOSI) |
+ * | 11  | Storage Register Clock Input (RCK)        | 48            |
+ * | 12  | GND                                       | -             |
+ * | 13  | LCD write  (+3.3V !)                      | 49 ⚡         |
+ * | 14  | GND                                       | -             |
+ *
+ * ⚡ Require a 3.3v level-shifter, screen makes shadows and may be destroyed after long use.
+ * 🔺 Require a 10k pull-up resistor wired between 3.3V and Arduino pin
+ */
+
+#if defined(ARDUINO_ARCH_AVR)
+#define BAUD_RATE 115200
+#else
+#define BAUD_RATE 9600
+#endif
+
+#include <Epson_PNL_CE02.h>
+#include <Epson_PNL_CE02_Display.h>
+#include <Epson_PNL_CE02_Text.h>
+
+Epson_PNL_CE02_Pinout pinout = {
+    /* Control panel to Arduino pinout */
+    .EXTENDER_OE = 45,  // FFC 1
+    .SERIAL_OUT = 50,   // SPI MISO / FFC 2
+    .POWER_BUTTON = 46, // FFC 4
+    .LCD_RESET = 47,    // FFC 6
+    .CLOCK = 52,        // SPI SCK / FFC 9
+    .SERIAL_IN = 51,    // SPI MOSI / FFC 10
+    .LATCH = 48,        // FFC 11
+    .LCD_WRITE = 49,    // FFC 13
+};
+
+Epson_PNL_CE02 controlPanel(&pinout);
+Epson_PNL_CE02_Display display(&controlPanel);
+Epson_PNL_CE02_Text text(&display);
+
+const int16_t WIDTH = Epson_PNL_CE02_Display::WIDTH;
+const int16_t HEIGHT = Epson_PNL_CE02_Display::HEIGHT;
+const uint16_t COLORS[] = {0xF800, 0x07E0, 0x001F, 0xFFE0};
+const int16_t RECT_SIZE = 16;
+const int16_t BITMAP_WIDTH = 32;
+const int16_t BITMAP_HEIGHT = 32;
+const char LINE[] = "The quick brown fox !"; // 21 characters, a whole line of the 6x8 font
+
+uint16_t bitmap[BITMAP_WIDTH * BITMAP_HEIGHT];
+volatile byte sink; // keeps reads
+
+/**
+ * @brief Run an operation `ops` times and print its line of results.
+ *
+ * @param pName name of the benchmark
+ * @param ops number of operations
+ * @param bytesPerOp payload of an operation
+ * @param operation called with the index of the operation
+ */
+template <class Operation>
+void benchmark(const __FlashStringHelper *pName, uint16_t ops, uint32_t bytesPerOp, Operation operation)
+{
+    const uint32_t start = micros();
+    for (uint16_t op = 0; op < ops; op++)
+    {
+        operation(op);
+    }
+    const uint32_t elapsed = micros() - start;
+
+    const double seconds = elapsed / 1000000.0;
+    Serial.print(pName);
+    Serial.print(',');
+    Serial.print(ops);
+    Serial.print(',');
+    Serial.print(static_cast<double>(elapsed) / ops, 2);
+    Serial.print(',');
+    Serial.print(ops / seconds, 2);
+    Serial.print(',');
+    Serial.println(ops * bytesPerOp / seconds, 0);
+}
+
+void setup()
+{
+    Serial.begin(BAUD_RATE);
+    controlPanel.begin();
+    display.begin();
+    controlPanel.extenderWrite(ExtenderPin::LCD_BACKLIGHT, HIGH);
+
+    for (int16_t i = 0; i < BITMAP_WIDTH * BITMAP_HEIGHT; i++)
+    {
+        bitmap[i] = Epson_PNL_CE02_Display::color565(i * 8, i / 4, 255 - i * 8);
+    }
+
+    Serial.println(F("# Epson_PNL_CE02 benchmark"));
+    Serial.print(F("# first pixel after "));
+    Serial.print(display.firstPixelMicros());
+    Serial.println(F(" us"));
+#if defined(EPSON_PNL_CE02_SIMULATOR)
+    Serial.println(F("# simulated bus time"));
+#endif
+    Serial.println(F("benchmark,ops,us_per_op,ops_per_s,bytes_per_s"));
+
+    benchmark(F("fillScreen"), 16, 2UL * WIDTH * HEIGHT,
+              [](uint16_t op) { display.fillRect(0, 0, WIDTH, HEIGHT, COLORS[op % 4]); });
+
+    benchmark(F("fillRect16"), 512, 2UL * RECT_SIZE * RECT_SIZE, [](uint16_t op) {
+        const int16_t x = (op * RECT_SIZE) % WIDTH;
+        const int16_t y = (op / (WIDTH / RECT_SIZE) * RECT_SIZE) % HEIGHT;
+        display.fillRect(x, y, RECT_SIZE, RECT_SIZE, COLORS[op % 4]);
+    });
+
+    benchmark(F("bitmap32"), 256, 2UL * BITMAP_WIDTH * BITMAP_HEIGHT, [](uint16_t op) {
+        const int16_t x = (op * BITMAP_WIDTH) % WIDTH;
+        const int16_t y = (op / (WIDTH / BITMAP_WIDTH) * BITMAP_HEIGHT) % HEIGHT;
+        display.drawBitmap(x, y, bitmap, BITMAP_WIDTH, BITMAP_HEIGHT);
+    });
+
+    benchmark(F("textLine"), 256, 2UL * text.textWidth(LINE) * text.lineHeight(), [](uint16_t op) {
+        text.setColors(COLORS[op % 4], 0x0000);
+        text.drawText(0, (op % (HEIGHT / 8)) * 8, LINE);
+    });
+
+    benchmark(F("pixel"), 4096, 2, [](uint16_t op) {
+        display.drawPixel((op * 7) % WIDTH, (op * 13) % HEIGHT, COLORS[op % 4]);
+    });
+
+    benchmark(F("extenderWrite"), 4096, 1,
+              [](uint16_t op) { controlPanel.extenderWrite(ExtenderPin::POWER_LED, op % 2); });
+
+    benchmark(F("readButtons"), 4096, 1, [](uint16_t) { sink = controlPanel.readButtons(); });
+
+    benchmark(F("begin"), 4, 2UL * WIDTH * HEIGHT, [](uint16_t) { display.begin(); }); // reset to first pixel
+
+    Serial.println(F("# done"));
+}
+
+void loop()
+{
+}
@@ -2,7 +2,7 @@
  * @file buttons.ino
  * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
  * @brief A basic buttons playground using Epson_PNL_CE02 library.
- * Get an advanced usage of buttons in the OneButton sketch.
+ * Get an advanced usage of buttons (clicks, double clicks, long presses, chords) in the full sketch.
  * @version 1.0
  *
  * @copyright MIT license
@@ -35,6 +35,7 @@
 #endif
 
 #include <Epson_PNL_CE02.h>
+#include <Epson_PNL_CE02_IdleManager.h>
 
 Epson_PNL_CE02_Pinout pinout = {
     /* Control panel to Arduino pinout */
@@ -49,6 +50,8 @@ Epson_PNL_CE02_Pinout pinout = {
 };
 
 Epson_PNL_CE02 controlPanel(&pinout);
+Epson_PNL_CE02_IdleManager idle(&controlPanel, 30000, 50); // idle after 30 s, scan every 50 ms
+EPSON_PNL_CE02_IDLE_MANAGER_ISR(); // wakes from power-down on AVR
 
 const byte OK = static_cast<byte>(ButtonMask::OK);
 const byte HOME = static_cast<byte>(ButtonMask::HOME);
@@ -57,11 +60,14 @@ void setup()
 {
     Serial.begin(BAUD_RATE);
     controlPanel.begin();
+    idle.begin();
 }
 
 void loop()
 {
-    switch (controlPanel.readButtons())
+    // Sleeps until the next scan, lights off and slow scans while idle
+    const uint16_t buttons = idle.scan();
+    switch (static_cast<byte>(buttons))
     {
     case OK:
         Serial.println("Button OK pressed!");
@@ -72,10 +78,10 @@ void loop()
     }
 
     // Power button has a dedicated pin
-    if (controlPanel.isPowerButtonPressed())
+    if ((buttons & POWER_BUTTON_MASK) != 0)
     {
         Serial.println("Button POWER pressed!");
     }
 
-    delay(50);
+    Serial.flush(); // the UART stops while idle
 }
\ No newline at end of file
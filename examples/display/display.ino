@@ -29,29 +29,13 @@
  * ⚡ Require a 3.3v level-shifter, screen makes shadows and may be destroyed after long use.
  * 🔺 Require a 10k pull-up resistor wired between 3.3V and Arduino pin
  *
- *
- * Adaptation:
- * 1. Download [MCUFRIEND_kbv v3](https://github.com/prenticedavid/MCUFRIEND_kbv)
- * 2. Edit *MCUFRIEND_kbv/utility/mcufriend_shield.h*:
- *    1. Uncomment `#define USE_SPECIAL`
- *    2. Uncomment `#define SUPPORT_9163`
- * 3. Edit *MCUFRIEND_kbv/MCUFRIEND_kbv.cpp*:
- *    1. Go to `#ifdef SUPPORT_9163` section
- *    2. Replace `*p16 = 160;` by `*p16 = 128;`
- * 5. Edit *MCUFRIEND_kbv/utility/mcufriend_special.h*:
- *    1. Write to the top of mcufriend_special.h `#define USE_EPSON_PNL_CE02`
- *    2. Copy content from *extras/mcufriend_specials/<ARDUINO_TYPE>.h* file
- *    3. Paste to the SPECIAL definitions of *mcufriend_special.h*, somewhere between `#if` and `#else`
- * 6. Your code requires:
- *    1. Definition for `Epson_PNL_CE02 controlPanel(...)`
- *    2. Turn display ON before INIT:
- *       ``` c++
- *       controlPanel.extenderWrite(LCD_BACKLIGHT, HIGH);
- *       tft.begin(0x9163);
- *
+ * The Epson_PNL_CE02_TFT class brings the Adafruit_GFX drawing API (text, shapes, bitmaps...).
+ * Install the Adafruit_GFX library via Library Manager
+ * if using the Arduino IDE, click here: http://librarymanager#Adafruit_GFX
  */
 
 #include <Epson_PNL_CE02.h>
+#include <Epson_PNL_CE02_TFT.h>
 
 /****************************** Epson_PNL_CE02 *******************************/
 Epson_PNL_CE02_Pinout pinout = {
@@ -68,17 +52,12 @@ Epson_PNL_CE02_Pinout pinout = {
 
 Epson_PNL_CE02 controlPanel(&pinout);
 
-/******************************* MCUFRIEND_kbv *******************************/
+/********************************* Display **********************************/
 
-// install the Adafruit_GFX library via Library Manager
-// if using the Arduino IDE, click here: http://librarymanager#Adafruit_GFX
-#include <Adafruit_GFX.h>
+Epson_PNL_CE02_TFT tft(&controlPanel);
 
-// install the MCUFRIEND_kbv library via Library Manager
-// if using the Arduino IDE, click here: http://librarymanager#MCUFRIEND_kbv
-#include <MCUFRIEND_kbv.h>
-
-MCUFRIEND_kbv tft;
+const uint16_t RED = 0xF800;
+const uint16_t BLACK = 0x0000;
 
 /*********************************** MAIN ************************************/
 
@@ -86,16 +65,13 @@ void setup()
 {
     controlPanel.begin();
 
-    // STEP 1: Turn display ON
-    controlPanel.extenderWrite(ExtenderPin::LCD_BACKLIGHT, HIGH);
-
-    // STEP 2: INIT display
-    tft.begin(0x9163); // Force ILI9163C as the control panel wired the display in write-only mode
+    // STEP 1: INIT display (reset, turn backlight ON)
+    tft.begin();
 
-    // STEP 3: Use display
-    tft.fillScreen(TFT_RED);
+    // STEP 2: Use display
+    tft.fillScreen(RED);
     tft.setCursor(5, 5);
-    tft.setTextColor(TFT_BLACK);
+    tft.setTextColor(BLACK);
     tft.print("Hello World");
 }
 
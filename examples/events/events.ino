@@ -0,0 +1,103 @@
+/**
+ * @file events.ino
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Buttons events scanned from a timer interrupt while the display is busy,
+ * using Epson_PNL_CE02 library. No press is lost during long screen fills.
+ * @version 1.0
+ *
+ * @copyright MIT license
+ *
+ * | Pin | Purpose                                   | MEGA 2560     |
+ * |-----|-------------------------------------------|---------------|
+ * | 1   | 3-STATE Output Enable Input (OE)          | 45            |
+ * | 2   | Serial Data Output (SER OUT)              | 50 (SPI MISO) |
+ * | 3   | GND                                       | GND           |
+ * | 4   | Power button                              | 46 🔺         |
+ * | 5   | 3.3V supply                               | 3.3V          |
+ * | 6   | LCD reset (+3.3V !)                       | 47 ⚡         |
+ * | 7   | LCD backlight (+5V !)                     | 5V            |
+ * | 8   | GND                                       | -             |
+ * | 9   | Shift Register Clock Input (SCK)          | 52 (SPI SCK)  |
+ * | 10  | Serial Data Input (SER IN)                | 51 (SPI MOSI) |
+ * | 11  | Storage Register Clock Input (RCK)        | 48            |
+ * | 12  | GND                                       | -             |
+ * | 13  | LCD write  (+3.3V !)                      | 49 ⚡         |
+ * | 14  | GND                                       | -             |
+ *
+ * ⚡ Require a 3.3v level-shifter, screen makes shadows and may be destroyed after long use.
+ * 🔺 Require a 10k pull-up resistor wired between 3.3V and Arduino pin
+ */
+
+#if defined(ARDUINO_ARCH_AVR)
+#define BAUD_RATE 115200
+#else
+#define BAUD_RATE 9600
+#endif
+
+#include <Epson_PNL_CE02.h>
+#include <Epson_PNL_CE02_ButtonScanner.h>
+#include <Epson_PNL_CE02_Display.h>
+
+#if defined(EPSON_PNL_CE02_SIMULATOR)
+#include <Epson_PNL_CE02_Simulator.h> // emulated timer interrupt
+#endif
+
+Epson_PNL_CE02_Pinout pinout = {
+    /* Control panel to Arduino pinout */
+    .EXTENDER_OE = 45,  // FFC 1
+    .SERIAL_OUT = 50,   // SPI MISO / FFC 2
+    .POWER_BUTTON = 46, // FFC 4
+    .LCD_RESET = 47,    // FFC 6
+    .CLOCK = 52,        // SPI SCK / FFC 9
+    .SERIAL_IN = 51,    // SPI MOSI / FFC 10
+    .LATCH = 48,        // FFC 11
+    .LCD_WRITE = 49,    // FFC 13
+};
+
+Epson_PNL_CE02 controlPanel(&pinout);
+Epson_PNL_CE02_Display display(&controlPanel);
+Epson_PNL_CE02_ButtonScanner scanner(&controlPanel);
+EPSON_PNL_CE02_BUTTON_SCANNER_ISR(); // scans from the Timer0 interrupt on AVR
+
+const uint16_t COLORS[] = {0xF800, 0x07E0, 0x001F, 0xFFFF};
+byte colorIndex = 0;
+
+void setup()
+{
+    Serial.begin(BAUD_RATE);
+    controlPanel.begin();
+    display.begin();
+
+    scanner.begin(10); // scan every 10 ms
+
+#if defined(EPSON_PNL_CE02_SIMULATOR)
+    simulator::board().setTimerInterrupt(1024, [] { scanner.tick(); });
+    simulator::board().scheduleButtons(millis() + 30, static_cast<byte>(ButtonMask::OK));
+    simulator::board().scheduleButtons(millis() + 90, 0);
+#elif !defined(ARDUINO_ARCH_AVR)
+    // call scanner.tick() every millisecond from a timer interrupt of your board
+#endif
+}
+
+void loop()
+{
+    // Long drawing, buttons are still scanned every 10 ms
+    display.fillRect(0, 0, Epson_PNL_CE02_Display::WIDTH, Epson_PNL_CE02_Display::HEIGHT, COLORS[colorIndex]);
+    colorIndex = (colorIndex + 1) % (sizeof(COLORS) / sizeof(COLORS[0]));
+
+    ButtonEvent event;
+    while (scanner.read(event))
+    {
+        Serial.print(event.time);
+        Serial.print(" ms: ");
+        if (event.button == POWER_BUTTON_MASK)
+        {
+            Serial.print("Power");
+        }
+        else
+        {
+            Serial.print(buttonName(static_cast<ButtonMask>(event.button)));
+        }
+        Serial.println(event.pressed ? " pressed" : " released");
+    }
+}
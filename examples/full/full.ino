@@ -1,8 +1,8 @@
 /**
  * @file full.ino
  * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
- * @brief Full playground using Epson_PNL_CE02 library with OneButton library
- * and MCUFRIEND_kbv. See "display" example to wire the display correctly.
+ * @brief Full playground using Epson_PNL_CE02 library with its gestures engine
+ * and Adafruit_GFX. See "display" example to wire the display correctly.
  * @version 1.0
  *
  * @copyright MIT license
@@ -26,8 +26,6 @@
  *
  * ⚡ Require a 3.3v level-shifter, screen makes shadows and may be destroyed after long use.
  * 🔺 Require a 10k pull-up resistor wired between 3.3V and Arduino pin
- *
- * Fix OneButton issue: https://github.com/mathertel/OneButton/issues/136#issuecomment-1891117014
  */
 
 #if defined(ARDUINO_ARCH_AVR)
@@ -36,11 +34,9 @@
 #define BAUD_RATE 9600
 #endif
 
-// install the OneButton library via Library Manager
-// if using the Arduino IDE, click here: http://librarymanager#OneButton
-#include <OneButton.h>
-
 #include <Epson_PNL_CE02.h>
+#include <Epson_PNL_CE02_Gestures.h>
+#include <Epson_PNL_CE02_TFT.h>
 
 Epson_PNL_CE02_Pinout pinout = {
     /* Control panel to Arduino pinout */
@@ -56,45 +52,52 @@ Epson_PNL_CE02_Pinout pinout = {
 
 Epson_PNL_CE02 controlPanel(&pinout);
 
-/******************************* MCUFRIEND_kbv *******************************/
+/********************************* Display **********************************/
 
 // install the Adafruit_GFX library via Library Manager
 // if using the Arduino IDE, click here: http://librarymanager#Adafruit_GFX
-#include <Adafruit_GFX.h>
-
-// install the MCUFRIEND_kbv library via Library Manager
-// if using the Arduino IDE, click here: http://librarymanager#MCUFRIEND_kbv
-#include <MCUFRIEND_kbv.h>
-
-MCUFRIEND_kbv tft;
+Epson_PNL_CE02_TFT tft(&controlPanel);
+
+// RGB565 colors
+#define TFT_LIGHTGREY 0xC618
+#define TFT_BLUE 0x001F
+#define TFT_ORANGE 0xFD20
+#define TFT_MAGENTA 0xF81F
+#define TFT_GREEN 0x07E0
+#define TFT_PURPLE 0x780F
+#define TFT_RED 0xF800
+#define TFT_YELLOW 0xFFE0
 
 /*********************************** MAIN ************************************/
 
-// Single buttons events
-OneButton *rightButton;
-OneButton *okButton;
-OneButton *upButton;
-OneButton *leftButton;
-OneButton *startButton;
-OneButton *downButton;
-OneButton *stopButton;
-OneButton *homeButton;
-
-// Parallel buttons events
-OneButton *homeOkButton;
+// Debounce, clicks, double clicks, long presses and chords of the 9 buttons
+Epson_PNL_CE02_Gestures gestures;
 
-// Power button has a dedicated pin
-OneButton powerButton(pinout.POWER_BUTTON);
-
-void printClick(void *button)
-{
-    Serial.print("Click: ");
-    Serial.println((char *)button);
-}
+const uint16_t HOME_OK = static_cast<byte>(ButtonMask::HOME) | static_cast<byte>(ButtonMask::OK);
 
-void colorClick(void *color)
+// Screen color of each button click
+uint16_t buttonColor(ButtonMask button)
 {
-    tft.fillScreen((uint16_t)color);
+    switch (button)
+    {
+    case ButtonMask::RIGHT:
+        return TFT_LIGHTGREY;
+    case ButtonMask::OK:
+        return TFT_BLUE;
+    case ButtonMask::UP:
+        return TFT_ORANGE;
+    case ButtonMask::LEFT:
+        return TFT_MAGENTA;
+    case ButtonMask::START:
+        return TFT_GREEN;
+    case ButtonMask::DOWN:
+        return TFT_PURPLE;
+    case ButtonMask::STOP:
+        return TFT_RED;
+    case ButtonMask::HOME:
+        return TFT_YELLOW;
+    }
+    return TFT_LIGHTGREY;
 }
 
 byte powerState = HIGH;
@@ -105,11 +108,34 @@ void togglePower()
     // reverse power (turns off when on, on when off)
     powerState = !powerState;
 
-    // send new power LED state.
+    // send new power LED and power SCREEN states in a single latch cycle.
+    controlPanel.beginExtenderUpdate();
     controlPanel.extenderWrite(ExtenderPin::POWER_LED, !powerState);
-
-    // send new power SCREEN state.
     controlPanel.extenderWrite(ExtenderPin::LCD_BACKLIGHT, powerState);
+    controlPanel.commitExtender();
+}
+
+void onClick(uint16_t buttons)
+{
+    Serial.print("Click: ");
+    if (buttons == POWER_BUTTON_MASK)
+    {
+        Serial.println("power");
+    }
+    else if (buttons == HOME_OK) // chord
+    {
+        Serial.println("home + ok");
+    }
+    else if (buttons <= 0xFF && (buttons & (buttons - 1)) == 0) // single button
+    {
+        const ButtonMask button = static_cast<ButtonMask>(buttons);
+        Serial.println(buttonName(button));
+        tft.fillScreen(buttonColor(button));
+    }
+    else
+    {
+        Serial.println(buttons, BIN);
+    }
 }
 
 // function declarations
@@ -118,67 +144,38 @@ void setup()
     Serial.begin(BAUD_RATE);
     controlPanel.begin();
 
-    controlPanel.extenderWrite(ExtenderPin::LCD_BACKLIGHT, HIGH);
-    tft.begin(0x9163); // ILI9163C
-
-    rightButton = new OneButton();
-    okButton = new OneButton();
-    upButton = new OneButton();
-    leftButton = new OneButton();
-    startButton = new OneButton();
-    downButton = new OneButton();
-    stopButton = new OneButton();
-    homeButton = new OneButton();
-
-    homeOkButton = new OneButton();
-
-    // Single buttons events
-    rightButton->attachClick(printClick, (void *)"right");
-    okButton->attachClick(printClick, (void *)"ok");
-    upButton->attachClick(printClick, (void *)"up");
-    leftButton->attachClick(printClick, (void *)"left");
-    startButton->attachClick(printClick, (void *)"start");
-    downButton->attachClick(printClick, (void *)"down");
-    stopButton->attachClick(printClick, (void *)"stop");
-    homeButton->attachClick(printClick, (void *)"home");
-
-    rightButton->attachClick(colorClick, (void *)TFT_LIGHTGREY);
-    okButton->attachClick(colorClick, (void *)TFT_BLUE);
-    upButton->attachClick(colorClick, (void *)TFT_ORANGE);
-    leftButton->attachClick(colorClick, (void *)TFT_MAGENTA);
-    startButton->attachClick(colorClick, (void *)TFT_GREEN);
-    downButton->attachClick(colorClick, (void *)TFT_PURPLE);
-    stopButton->attachClick(colorClick, (void *)TFT_RED);
-    homeButton->attachClick(colorClick, (void *)TFT_YELLOW);
-
-    homeButton->attachDoubleClick(printClick, (void *)"home x2");
-    homeButton->attachLongPressStop(printClick, (void *)"home long");
-
-    // Parallel buttons events
-    homeOkButton->attachClick(printClick, (void *)"home + ok");
-
-    powerButton.attachClick(printClick, (void *)"power");
-    powerButton.attachLongPressStop(togglePower);
+    tft.begin(); // ILI9163C, backlight ON
 }
 
 void loop()
 {
-    byte buttonsSequence = controlPanel.readButtons();
-
-    rightButton->tick(isButtonPressed(buttonsSequence, ButtonMask::RIGHT));
-    okButton->tick(isButtonPressed(buttonsSequence, ButtonMask::OK));
-    upButton->tick(isButtonPressed(buttonsSequence, ButtonMask::UP));
-    leftButton->tick(isButtonPressed(buttonsSequence, ButtonMask::LEFT));
-    startButton->tick(isButtonPressed(buttonsSequence, ButtonMask::START));
-    downButton->tick(isButtonPressed(buttonsSequence, ButtonMask::DOWN));
-    stopButton->tick(isButtonPressed(buttonsSequence, ButtonMask::STOP));
-    homeButton->tick(isButtonPressed(buttonsSequence, ButtonMask::HOME));
-
-    // Custom isButtonPressed bits manipulation
-    homeOkButton->tick(isButtonPressed(buttonsSequence, ButtonMask::HOME) &&
-                       isButtonPressed(buttonsSequence, ButtonMask::OK));
-
-    powerButton.tick();
-
-    delay(50);
+    const uint16_t sequence =
+        controlPanel.readButtons() | (controlPanel.isPowerButtonPressed() ? POWER_BUTTON_MASK : 0);
+
+    switch (gestures.update(sequence))
+    {
+    case Gesture::CLICK:
+        onClick(gestures.buttons());
+        break;
+    case Gesture::DOUBLE_CLICK:
+        if (gestures.buttons() == static_cast<byte>(ButtonMask::HOME))
+        {
+            Serial.println("Click: home x2");
+        }
+        break;
+    case Gesture::LONG_PRESS:
+        if (gestures.buttons() == static_cast<byte>(ButtonMask::HOME))
+        {
+            Serial.println("Click: home long");
+        }
+        else if (gestures.buttons() == POWER_BUTTON_MASK)
+        {
+            togglePower();
+        }
+        break;
+    case Gesture::NONE:
+        break;
+    }
+
+    delay(5);
 }
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+# Convert a fixed-width BDF font to the PROGMEM format drawn by Epson_PNL_CE02_Text (refer to
+# src/Epson_PNL_CE02_Font.h).
+#
+# Usage: pnl_font.py terminus.bdf [-o terminus.h] [--name TERMINUS] [--first 32] [--last 126] [--spacing 0]
+#
+# Only the Python standard library is required. Glyphs are placed in character cells of the font bounding box, on
+# the font baseline; `--spacing` adds blank columns on the right and a blank row at the bottom of every cell.
+# Xavier BRASSOUD - v1.0
+
+import argparse
+import os
+import re
+import sys
+
+MAX_WIDTH = 32
+
+
+def read_bdf(path):
+    """Return the cell (width, height, ascent) and the glyph rows of each character, as strings of 0 and 1."""
+    with open(path) as file:
+        lines = file.read().splitlines()
+
+    box = None
+    ascent = None
+    glyphs = {}
+    encoding = None
+    bbx = None
+    bitmap = None
+    for line in lines:
+        fields = line.split()
+        if not fields:
+            continue
+        keyword = fields[0]
+        if keyword == "FONTBOUNDINGBOX":
+            box = [int(value) for value in fields[1:5]]
+        elif keyword == "FONT_ASCENT":
+            ascent = int(fields[1])
+        elif keyword == "ENCODING":
+            encoding = int(fields[1])
+        elif keyword == "BBX":
+            bbx = [int(value) for value in fields[1:5]]
+        elif keyword == "BITMAP":
+            bitmap = []
+        elif keyword == "ENDCHAR":
+            width, height, x_offset, y_offset = bbx
+            rows = [bin(int(row, 16))[2:].zfill(len(row) * 4)[:width] for row in bitmap]
+            glyphs[encoding] = (x_offset, y_offset, height, rows)
+            bitmap = None
+        elif bitmap is not None:
+            bitmap.append(line.strip())
+
+    if box is None:
+        raise ValueError("FONTBOUNDINGBOX is missing")
+    width, height, x_origin, y_origin = box
+    if ascent is None:
+        ascent = height + y_origin
+
+    cells = {}
+    for code, (x_offset, y_offset, glyph_height, rows) in glyphs.items():
+        cell = [[0] * width for _ in range(height)]
+        top = ascent - y_offset - glyph_height
+        for row_index, row in enumerate(rows):
+            for column_index, bit in enumerate(row):
+                x = x_offset - x_origin + column_index
+                y = top + row_index
+                if bit == "1" and 0 <= x < width and 0 <= y < height:
+                    cell[y][x] = 1
+        cells[code] = cell
+    return width, height, cells
+
+
+def encode(cell, width, height):
+    """Rows of a cell, most significant bit on the left."""
+    out = bytearray()
+    row_bytes = (width + 7) // 8
+    for y in range(height):
+        value = 0
+        for x in range(row_bytes * 8):
+            value = value << 1 | (cell[y][x] if y < len(cell) and x < len(cell[y]) else 0)
+        out += value.to_bytes(row_bytes, "big")
+    return out
+
+
+def convert(path, first, last, spacing):
+    width, height, cells = read_bdf(path)
+    width += spacing
+    height += spacing
+    if not 0 < width <= MAX_WIDTH or not 0 < height <= 255:
+        raise ValueError(f"cells are {width}x{height}, at most {MAX_WIDTH}x255")
+    blank = [[0] * width for _ in range(height)]
+    glyphs = [encode(cells.get(code, blank), width, height) for code in range(first, last + 1)]
+    missing = [code for code in range(first, last + 1) if code not in cells]
+    return width, height, glyphs, missing
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert a BDF font to the Epson_PNL_CE02 PROGMEM font format.")
+    parser.add_argument("input", help="fixed-width BDF font")
+    parser.add_argument("-o", "--output", help="C header to write (default: input name with .h)")
+    parser.add_argument("--name", help="font name (default: input name in upper case)")
+    parser.add_argument("--first", type=int, default=32, help="first character (default: 32)")
+    parser.add_argument("--last", type=int, default=126, help="last character (default: 126)")
+    parser.add_argument("--spacing", type=int, default=0, help="blank pixels added between cells (default: 0)")
+    args = parser.parse_args()
+
+    if not 0 <= args.first <= args.last <= 255:
+        sys.exit("characters must be 0 <= first <= last <= 255")
+    base = os.path.splitext(os.path.basename(args.input))[0]
+    name = args.name or re.sub(r"\W", "_", base).upper()
+    output = args.output or os.path.splitext(args.input)[0] + ".h"
+    try:
+        width, height, glyphs, missing = convert(args.input, args.first, args.last, args.spacing)
+    except (OSError, ValueError, TypeError, IndexError) as error:
+        sys.exit(f"{args.input}: {error}")
+
+    size = sum(len(glyph) for glyph in glyphs)
+    with open(output, "w") as file:
+        file.write(f"// Generated by pnl_font.py from {os.path.basename(args.input)}\n")
+        file.write(f"// {width}x{height} cells, characters {args.first} to {args.last}, {size} bytes\n\n")
+        file.write("#include <Epson_PNL_CE02_Font.h>\n\n")
+        file.write(f"const byte {name}_GLYPHS[] PROGMEM = {{\n")
+        for code, glyph in zip(range(args.first, args.last + 1), glyphs):
+            label = f" // '{chr(code)}'" if 32 < code < 127 and chr(code) != "\\" else f" // {code}"
+            file.write("    " + ", ".join(f"0x{value:02X}" for value in glyph) + "," + label + "\n")
+        file.write("};\n\n")
+        file.write(
+            f"const Epson_PNL_CE02_Font {name} = {{{name}_GLYPHS, {width}, {height}, {args.first}, {args.last}}};\n"
+        )
+    print(f"{output}: {name} {width}x{height}, {len(glyphs)} characters, {size} bytes")
+    if missing:
+        print(f"{len(missing)} characters missing from the font are blank")
+
+
+if __name__ == "__main__":
+    main()
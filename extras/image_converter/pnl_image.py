@@ -0,0 +1,225 @@
+#!/usr/bin/env python3
+# Convert a PNG (or binary PPM) image to the compressed PROGMEM format drawn by
+# Epson_PNL_CE02_Display::drawImage_P() (refer to src/Epson_PNL_CE02_Image.h).
+#
+# Usage: pnl_image.py splash.png [-o splash.h] [--name SPLASH]
+#
+# Only the Python standard library is required. PNG files must be non-interlaced, 8 bits per channel, or paletted.
+# Colors are converted to RGB565; images with more than 256 colors are posterized until 256 colors remain.
+# Xavier BRASSOUD - v1.0
+
+import argparse
+import os
+import re
+import struct
+import sys
+import zlib
+
+FORMAT = 0xCE
+MAX_SIZE = 128
+MAX_LITERAL = 128
+MAX_SHORT_RUN = 64
+MAX_LONG_RUN = 16384
+
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def read_png(path):
+    with open(path, "rb") as file:
+        data = file.read()
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise ValueError("not a PNG file")
+
+    offset = 8
+    idat = b""
+    palette = []
+    while offset < len(data):
+        length, kind = struct.unpack(">I4s", data[offset : offset + 8])
+        chunk = data[offset + 8 : offset + 8 + length]
+        offset += 12 + length
+        if kind == b"IHDR":
+            width, height, depth, color_type, _, _, interlace = struct.unpack(">IIBBBBB", chunk)
+        elif kind == b"PLTE":
+            palette = [tuple(chunk[i : i + 3]) for i in range(0, len(chunk), 3)]
+        elif kind == b"IDAT":
+            idat += chunk
+        elif kind == b"IEND":
+            break
+
+    if interlace != 0:
+        raise ValueError("interlaced PNG files are not supported")
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color_type]
+    if color_type != 3 and depth != 8:
+        raise ValueError("only 8 bits per channel are supported")
+
+    # Unfilter rows
+    raw = zlib.decompress(idat)
+    row_bytes = (width * channels * depth + 7) // 8
+    step = max(1, channels * depth // 8)
+    rows = []
+    previous = bytearray(row_bytes)
+    position = 0
+    for _ in range(height):
+        kind = raw[position]
+        row = bytearray(raw[position + 1 : position + 1 + row_bytes])
+        position += 1 + row_bytes
+        for i in range(row_bytes):
+            left = row[i - step] if i >= step else 0
+            up = previous[i]
+            up_left = previous[i - step] if i >= step else 0
+            if kind == 1:
+                row[i] = (row[i] + left) & 0xFF
+            elif kind == 2:
+                row[i] = (row[i] + up) & 0xFF
+            elif kind == 3:
+                row[i] = (row[i] + (left + up) // 2) & 0xFF
+            elif kind == 4:
+                row[i] = (row[i] + paeth(left, up, up_left)) & 0xFF
+        rows.append(row)
+        previous = row
+
+    pixels = []
+    for row in rows:
+        for x in range(width):
+            if color_type == 3:
+                bit = x * depth
+                index = (row[bit // 8] >> (8 - depth - bit % 8)) & ((1 << depth) - 1)
+                pixels.append(palette[index])
+            elif color_type in (0, 4):
+                gray = row[x * channels]
+                pixels.append((gray, gray, gray))
+            else:
+                pixels.append(tuple(row[x * channels : x * channels + 3]))
+    return width, height, pixels
+
+
+def read_ppm(path):
+    with open(path, "rb") as file:
+        data = file.read()
+    match = re.match(rb"P6\s+(?:#.*\s+)*(\d+)\s+(\d+)\s+(\d+)\s", data)
+    if match is None or int(match.group(3)) != 255:
+        raise ValueError("only binary PPM (P6) files with 8 bits per channel are supported")
+    width, height = int(match.group(1)), int(match.group(2))
+    body = data[match.end() :]
+    pixels = [tuple(body[i : i + 3]) for i in range(0, width * height * 3, 3)]
+    return width, height, pixels
+
+
+def rgb565(red, green, blue, dropped=0):
+    red = (red >> (3 + dropped)) << dropped
+    green = (green >> (2 + dropped)) << dropped
+    blue = (blue >> (3 + dropped)) << dropped
+    return red << 11 | green << 5 | blue
+
+
+def quantize(pixels):
+    """Convert pixels to RGB565, dropping low bits until the palette fits 256 colors."""
+    for dropped in range(5):
+        colors = [rgb565(*pixel, dropped=dropped) for pixel in pixels]
+        palette = sorted(set(colors), key=colors.index)
+        if len(palette) <= 256:
+            return colors, palette
+    raise ValueError("too many colors")
+
+
+def bits_per_index(colors):
+    for bits in (1, 2, 4):
+        if colors <= 1 << bits:
+            return bits
+    return 8
+
+
+def encode(indexes, bits):
+    """Palette indexes to packets (refer to src/Epson_PNL_CE02_Image.h)."""
+    min_run = max(3, 24 // bits)  # a shorter run costs more bytes than its literal indexes
+    out = bytearray()
+    literal = []
+
+    def flush_literal():
+        while literal:
+            chunk = literal[:MAX_LITERAL]
+            del literal[:MAX_LITERAL]
+            out.append(len(chunk) - 1)
+            value = 0
+            used = 0
+            for index in chunk:
+                value = value << bits | index
+                used += bits
+                if used == 8:
+                    out.append(value)
+                    value = used = 0
+            if used > 0:
+                out.append(value << (8 - used))
+
+    position = 0
+    while position < len(indexes):
+        end = position
+        while end < len(indexes) and indexes[end] == indexes[position]:
+            end += 1
+        length = end - position
+        if length < min_run:
+            literal.extend(indexes[position:end])
+        else:
+            flush_literal()
+            while length > 0:
+                run = min(length, MAX_LONG_RUN)
+                if run <= MAX_SHORT_RUN:
+                    out += bytes((0x80 | (run - 1), indexes[position]))
+                else:
+                    out += bytes((0xC0 | (run - 1) >> 8, (run - 1) & 0xFF, indexes[position]))
+                length -= run
+        position = end
+    flush_literal()
+    return out
+
+
+def convert(path):
+    if path.lower().endswith(".ppm"):
+        width, height, pixels = read_ppm(path)
+    else:
+        width, height, pixels = read_png(path)
+    if not (0 < width <= MAX_SIZE and 0 < height <= MAX_SIZE):
+        raise ValueError(f"image is {width}x{height}, at most {MAX_SIZE}x{MAX_SIZE}")
+
+    colors, palette = quantize(pixels)
+    lookup = {color: index for index, color in enumerate(palette)}
+    image = bytearray((FORMAT, width, height, len(palette) - 1))
+    for color in palette:
+        image += struct.pack(">H", color)
+    image += encode([lookup[color] for color in colors], bits_per_index(len(palette)))
+    return width, height, len(palette), image
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert an image to the Epson_PNL_CE02 compressed PROGMEM format.")
+    parser.add_argument("input", help="PNG or binary PPM image, up to 128x128")
+    parser.add_argument("-o", "--output", help="C header to write (default: input name with .h)")
+    parser.add_argument("--name", help="array name (default: input name in upper case)")
+    args = parser.parse_args()
+
+    base = os.path.splitext(os.path.basename(args.input))[0]
+    name = args.name or re.sub(r"\W", "_", base).upper()
+    output = args.output or os.path.splitext(args.input)[0] + ".h"
+    try:
+        width, height, colors, image = convert(args.input)
+    except (OSError, ValueError, KeyError, zlib.error) as error:
+        sys.exit(f"{args.input}: {error}")
+
+    raw = width * height * 2
+    lines = [", ".join(f"0x{value:02X}" for value in image[i : i + 16]) for i in range(0, len(image), 16)]
+    with open(output, "w") as file:
+        file.write(f"// Generated by pnl_image.py from {os.path.basename(args.input)}\n")
+        file.write(f"// {width}x{height}, {colors} colors, {len(image)} bytes ({raw} bytes in RGB565)\n\n")
+        file.write("#include <Arduino.h>\n\n")
+        file.write(f"const byte {name}[] PROGMEM = {{\n    " + ",\n    ".join(lines) + "\n};\n")
+    print(f"{output}: {name} {width}x{height}, {colors} colors, {len(image)} bytes, {raw / len(image):.1f}x smaller")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,388 @@
+#!/usr/bin/env python3
+# Host side of the serial protocol of Epson_PNL_CE02_Remote (refer to src/Epson_PNL_CE02_Remote.h): frames are
+# rendered on the computer, only the changed rectangles are sent (RLE encoded, or filled when of a single color), and
+# button events of the panel are printed.
+#
+# Usage: pnl_remote.py (--port /dev/ttyACM0 [--baud 1000000] | --simulator PROGRAM) demo [--frames 200]
+#        pnl_remote.py (--port /dev/ttyACM0 [--baud 1000000] | --simulator PROGRAM) image picture.ppm
+#
+# Only the Python standard library is required (POSIX serial ports). `--simulator` runs a native build of
+# examples/remote (`pio run -e native_remote`) on a pseudo-terminal instead of a serial port.
+# Xavier BRASSOUD - v1.0
+
+import argparse
+import os
+import re
+import select
+import subprocess
+import sys
+import termios
+import time
+import tty
+
+WIDTH = 128
+HEIGHT = 128
+SYNC = 0xA5
+
+# Host to panel
+PING = 0x01
+FILL = 0x10
+RECT = 0x11
+EXTENDER = 0x20
+
+# Panel to host
+INFO = 0x81
+CREDIT = 0x82
+BUTTONS = 0x83
+ERROR = 0x84
+
+MAX_TOKEN = 128
+MERGE_DISTANCE = 8  # columns between the changes of two rows still sent as a single rectangle
+BUTTON_NAMES = ((0x80, "Right"), (0x40, "Ok"), (0x20, "Up"), (0x10, "Left"),
+                (0x08, "Start"), (0x04, "Down"), (0x02, "Stop"), (0x01, "Home"))
+ERROR_NAMES = {1: "CRC", 2: "unknown command", 3: "invalid payload"}
+
+
+def crc8(data, crc=0):
+    """CRC-8, polynomial 0x07, initial value 0."""
+    for value in data:
+        crc ^= value
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def frame(command, payload=b""):
+    body = bytes([command, len(payload) & 0xFF, len(payload) >> 8]) + bytes(payload)
+    return bytes([SYNC]) + body + bytes([crc8(body)])
+
+
+def rgb565(red, green, blue):
+    return (red >> 3) << 11 | (green >> 2) << 5 | blue >> 3
+
+
+def color_bytes(color):
+    return bytes([color & 0xFF, color >> 8])
+
+
+def rle(pixels):
+    """RLE tokens of the RECT command: runs of a color, or literal pixels."""
+    tokens = bytearray()
+    literal = []
+
+    def flush():
+        if literal:
+            tokens.append(len(literal) - 1)
+            for color in literal:
+                tokens.extend(color_bytes(color))
+            literal.clear()
+
+    index = 0
+    while index < len(pixels):
+        run = 1
+        while index + run < len(pixels) and run < MAX_TOKEN and pixels[index + run] == pixels[index]:
+            run += 1
+        if run >= 2:
+            flush()
+            tokens.append(0x80 | (run - 1))
+            tokens.extend(color_bytes(pixels[index]))
+        else:
+            literal.append(pixels[index])
+            if len(literal) == MAX_TOKEN:
+                flush()
+        index += run
+    flush()
+    return bytes(tokens)
+
+
+def encode_rect(pixels, x, y, w, h):
+    """FILL when the rectangle has a single color, RECT otherwise."""
+    area = [pixels[row * WIDTH + x + column] for row in range(y, y + h) for column in range(w)]
+    if all(color == area[0] for color in area):
+        return frame(FILL, bytes([x, y, w, h]) + color_bytes(area[0]))
+    return frame(RECT, bytes([x, y, w, h]) + rle(area))
+
+
+def changed_rects(previous, current):
+    """Rectangles covering the pixels changed, consecutive rows with close changes are merged."""
+    if previous is None:
+        return [(0, 0, WIDTH, HEIGHT)]
+    rects = []
+    pending = None  # [left, top, right, bottom]
+    for y in range(HEIGHT):
+        row = y * WIDTH
+        changed = [x for x in range(WIDTH) if previous[row + x] != current[row + x]]
+        if not changed:
+            if pending is not None:
+                rects.append(pending)
+                pending = None
+            continue
+        left, right = changed[0], changed[-1]
+        if pending is not None and left <= pending[2] + MERGE_DISTANCE and right >= pending[0] - MERGE_DISTANCE:
+            pending = [min(left, pending[0]), pending[1], max(right, pending[2]), y]
+        else:
+            if pending is not None:
+                rects.append(pending)
+            pending = [left, y, right, y]
+    if pending is not None:
+        rects.append(pending)
+    return [(left, top, right - left + 1, bottom - top + 1) for left, top, right, bottom in rects]
+
+
+def encode_delta(previous, current):
+    """Frames updating the panel from `previous` (None: unknown content) to `current`."""
+    return b"".join(encode_rect(current, *rect) for rect in changed_rects(previous, current))
+
+
+class Link:
+    """Framed link to the panel, with the credit-based flow control."""
+
+    def __init__(self, fd):
+        self.fd = fd
+        self.received = bytearray()
+        self.window = 0
+        self.credits = 0
+        self.connected = False
+        self.events = []
+        self.errors = []
+
+    def connect(self, timeout=5.0):
+        self.poll(0.2)  # drop what was sent before, e.g. INFO at boot
+        self.received.clear()
+        self.events.clear()
+        self.connected = False
+        deadline = time.monotonic() + timeout
+        while not self.connected:
+            if time.monotonic() > deadline:
+                raise TimeoutError("no answer from the panel")
+            self.write(frame(PING))
+            end = time.monotonic() + 1.0
+            while not self.connected and time.monotonic() < end:
+                self.poll(0.05)
+
+    def send(self, data):
+        """Send bytes, waiting for credits."""
+        offset = 0
+        while offset < len(data):
+            if self.credits == 0:
+                if not self.poll(2.0):
+                    raise TimeoutError("no credit from the panel")
+                continue
+            count = min(self.credits, len(data) - offset)
+            self.write(data[offset : offset + count])
+            self.credits -= count
+            offset += count
+            self.poll(0)
+
+    def synchronize(self, timeout=5.0):
+        """Wait until everything sent is drawn: PING is answered once the frames before it are handled."""
+        self.connected = False  # before sending: send() may already handle the INFO answer
+        self.send(frame(PING))
+        deadline = time.monotonic() + timeout
+        while not self.connected:
+            if time.monotonic() > deadline:
+                raise TimeoutError("no answer from the panel")
+            self.poll(0.05)
+
+    def write(self, data):
+        view = memoryview(data)
+        while view:
+            select.select([], [self.fd], [])
+            view = view[os.write(self.fd, view) :]
+
+    def poll(self, timeout):
+        """Read and handle frames from the panel, return True if something was received."""
+        ready, _, _ = select.select([self.fd], [], [], timeout)
+        if not ready:
+            return False
+        try:
+            data = os.read(self.fd, 4096)
+        except OSError:
+            data = b""
+        if not data:
+            raise ConnectionError("the panel hung up")
+        self.received.extend(data)
+        self.parse()
+        return True
+
+    def parse(self):
+        while True:
+            start = self.received.find(SYNC)
+            if start < 0:
+                self.received.clear()
+                return
+            del self.received[:start]
+            if len(self.received) < 4:
+                return
+            length = self.received[2] | self.received[3] << 8
+            if len(self.received) < 5 + length:
+                return
+            body = bytes(self.received[1 : 4 + length])
+            if crc8(body) != self.received[4 + length]:
+                del self.received[:1]  # not a frame, resynchronize
+                continue
+            del self.received[: 5 + length]
+            self.handle(body[0], body[3:])
+
+    def handle(self, command, payload):
+        if command == INFO:
+            self.window = payload[3] | payload[4] << 8
+            self.credits = self.window
+            self.connected = True
+        elif not self.connected:
+            return  # credits of a previous session
+        elif command == CREDIT:
+            self.credits += payload[0] | payload[1] << 8
+        elif command == BUTTONS:
+            self.events.append((payload[0], payload[1] != 0))
+        elif command == ERROR:
+            self.errors.append((payload[0], payload[1]))
+            print(f"panel error: {ERROR_NAMES.get(payload[0], payload[0])} (command 0x{payload[1]:02X})",
+                  file=sys.stderr)
+
+
+class Canvas:
+    """RGB565 frame rendered on the host."""
+
+    # 3x5 digits, 3 bits per row
+    DIGIT_ROWS = (
+        (7, 5, 5, 5, 7), (2, 6, 2, 2, 7), (7, 1, 7, 4, 7), (7, 1, 3, 1, 7), (5, 5, 7, 1, 1),
+        (7, 4, 7, 1, 7), (7, 4, 7, 5, 7), (7, 1, 1, 1, 1), (7, 5, 7, 5, 7), (7, 5, 7, 1, 7),
+    )
+
+    def __init__(self, color=0):
+        self.pixels = [color] * (WIDTH * HEIGHT)
+
+    def fill_rect(self, x, y, w, h, color):
+        for row in range(max(y, 0), min(y + h, HEIGHT)):
+            start = row * WIDTH
+            for column in range(max(x, 0), min(x + w, WIDTH)):
+                self.pixels[start + column] = color
+
+    def draw_number(self, x, y, number, scale, color):
+        for digit in str(number):
+            for line, bits in enumerate(self.DIGIT_ROWS[int(digit)]):
+                for column in range(3):
+                    if bits & (4 >> column):
+                        self.fill_rect(x + column * scale, y + line * scale, scale, scale, color)
+            x += 4 * scale
+
+
+def render_demo(index, buttons):
+    """Dashboard: frame counter, animated gauges, pressed buttons."""
+    canvas = Canvas(rgb565(0, 0, 32))
+    canvas.fill_rect(0, 0, WIDTH, 20, rgb565(0, 64, 128))
+    canvas.draw_number(4, 3, index, 3, 0xFFFF)
+    colors = (rgb565(255, 64, 64), rgb565(64, 255, 64), rgb565(64, 128, 255), rgb565(255, 200, 0))
+    for gauge, color in enumerate(colors):
+        phase = (index * (gauge + 2)) % 200
+        level = phase if phase < 100 else 200 - phase
+        y = 30 + gauge * 16
+        canvas.fill_rect(4, y, 120, 10, rgb565(40, 40, 60))
+        canvas.fill_rect(4, y, 120 * level // 100, 10, color)
+    for bit, (mask, _) in enumerate(BUTTON_NAMES):
+        pressed = buttons & mask
+        canvas.fill_rect(4 + bit * 15, 100, 12, 12, 0xFFFF if pressed else rgb565(60, 60, 60))
+    return canvas.pixels
+
+
+def print_events(link, state):
+    for buttons, power in link.events:
+        for mask, name in BUTTON_NAMES:
+            if (buttons ^ state[0]) & mask:
+                print(f"{name} {'pressed' if buttons & mask else 'released'}")
+        if power != state[1]:
+            print(f"Power {'pressed' if power else 'released'}")
+        state[0], state[1] = buttons, power
+    link.events.clear()
+
+
+def run_demo(link, frames):
+    previous = None
+    state = [0, False]
+    sent = 0
+    start = time.monotonic()
+    for index in range(frames):
+        current = render_demo(index, state[0])
+        data = encode_delta(previous, current)
+        link.send(data)
+        sent += len(data)
+        previous = current
+        print_events(link, state)
+    link.synchronize()
+    elapsed = time.monotonic() - start
+    print(f"frames={frames} seconds={elapsed:.2f} fps={frames / elapsed:.1f} bytes_per_frame={sent // frames}")
+
+
+def read_ppm(path):
+    with open(path, "rb") as file:
+        data = file.read()
+    match = re.match(rb"P6\s+(?:#.*\s+)*(\d+)\s+(\d+)\s+(\d+)\s", data)
+    if match is None or int(match.group(3)) != 255:
+        raise ValueError("only binary PPM (P6) files with 8 bits per channel are supported")
+    width, height = int(match.group(1)), int(match.group(2))
+    body = data[match.end() :]
+    canvas = Canvas()
+    for y in range(min(height, HEIGHT)):
+        for x in range(min(width, WIDTH)):
+            offset = (y * width + x) * 3
+            canvas.pixels[y * WIDTH + x] = rgb565(*body[offset : offset + 3])
+    return canvas.pixels
+
+
+def open_port(path, baud):
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+    tty.setraw(fd)
+    attributes = termios.tcgetattr(fd)
+    speed = getattr(termios, f"B{baud}")
+    attributes[4] = attributes[5] = speed
+    termios.tcsetattr(fd, termios.TCSANOW, attributes)
+    time.sleep(2.0)  # most boards reset when the port is opened
+    return fd
+
+
+def open_simulator(program):
+    master, slave = os.openpty()
+    tty.setraw(slave)  # no echo before the simulator opens it
+    environment = dict(os.environ, PNL_SIM_SERIAL=os.ttyname(slave))
+    process = subprocess.Popen([program], env=environment)
+    return master, slave, process
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Drive an Epson_PNL_CE02_Remote panel from this computer.")
+    target = parser.add_mutually_exclusive_group(required=True)
+    target.add_argument("--port", help="serial port of the board")
+    target.add_argument("--simulator", help="native build of examples/remote, run on a pseudo-terminal")
+    parser.add_argument("--baud", type=int, default=1000000)
+    commands = parser.add_subparsers(dest="command", required=True)
+    demo = commands.add_parser("demo", help="animated dashboard, prints the frame rate")
+    demo.add_argument("--frames", type=int, default=200)
+    image = commands.add_parser("image", help="show a binary PPM image")
+    image.add_argument("path")
+    args = parser.parse_args()
+
+    process = None
+    if args.simulator:
+        fd, slave, process = open_simulator(args.simulator)
+    else:
+        fd = open_port(args.port, args.baud)
+    try:
+        link = Link(fd)
+        link.connect()
+        if process is not None:
+            os.close(slave)  # kept open until then: reading a pseudo-terminal without slave fails
+        if args.command == "demo":
+            run_demo(link, args.frames)
+        else:
+            link.send(encode_delta(None, read_ppm(args.path)))
+            link.synchronize()
+        return 1 if link.errors else 0
+    finally:
+        os.close(fd)
+        if process is not None:
+            process.wait()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
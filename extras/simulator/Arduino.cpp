@@ -0,0 +1,425 @@
+/**
+ * @file Arduino.cpp
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Host-side replacement of the Arduino core for the PNL CE02 simulator.
+ *
+ * Provides `main()` running the sketch, configured from environment variables:
+ *  => PNL_SIM_LOOPS: number of `loop()` calls (default: 1)
+ *  => PNL_SIM_SNAPSHOT: write the panel content to this PPM file at exit
+ *  => PNL_SIM_GOLDEN: compare the panel content with this PPM file at exit, fails on mismatch
+ *  => PNL_SIM_SERIAL: host serial device (e.g. a pseudo-terminal) used by `Serial` instead of the standard output,
+ *     `loop()` is called until the device hangs up when PNL_SIM_LOOPS is not set
+ *
+ * Define PNL_SIM_NO_MAIN to provide your own `main()`.
+ *
+ * @copyright MIT license
+ */
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#include "Epson_PNL_CE02_Simulator.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+// PRINT
+size_t Print::write(const uint8_t *pBuffer, size_t size)
+{
+    size_t written = 0;
+    while (size-- > 0)
+    {
+        written += write(*pBuffer++);
+    }
+    return written;
+}
+
+size_t Print::print(const __FlashStringHelper *pStr)
+{
+    return print(reinterpret_cast<const char *>(pStr));
+}
+
+size_t Print::print(const char *pStr)
+{
+    return write(pStr);
+}
+
+size_t Print::print(char value)
+{
+    return write(static_cast<uint8_t>(value));
+}
+
+size_t Print::print(unsigned char value, int base)
+{
+    return print(static_cast<unsigned long>(value), base);
+}
+
+size_t Print::print(int value, int base)
+{
+    return print(static_cast<long>(value), base);
+}
+
+size_t Print::print(unsigned int value, int base)
+{
+    return print(static_cast<unsigned long>(value), base);
+}
+
+size_t Print::print(long value, int base)
+{
+    if (base == DEC && value < 0)
+    {
+        return print('-') + printNumber(static_cast<unsigned long>(-value), base);
+    }
+    return printNumber(static_cast<unsigned long>(value), base);
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+    return printNumber(value, base);
+}
+
+size_t Print::print(double value, int digits)
+{
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+    return print(buffer);
+}
+
+size_t Print::println(const __FlashStringHelper *pStr)
+{
+    return print(pStr) + println();
+}
+
+size_t Print::println(const char *pStr)
+{
+    return print(pStr) + println();
+}
+
+size_t Print::println(char value)
+{
+    return print(value) + println();
+}
+
+size_t Print::println(unsigned char value, int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(int value, int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(unsigned int value, int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(long value, int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(unsigned long value, int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(double value, int digits)
+{
+    return print(value, digits) + println();
+}
+
+size_t Print::println()
+{
+    return write("\r\n");
+}
+
+size_t Print::printNumber(unsigned long value, int base)
+{
+    char buffer[8 * sizeof(long) + 1];
+    char *str = &buffer[sizeof(buffer) - 1];
+    *str = '\0';
+    if (base < 2)
+    {
+        base = DEC;
+    }
+    do
+    {
+        const char digit = static_cast<char>(value % base);
+        value /= base;
+        *--str = static_cast<char>(digit < 10 ? digit + '0' : digit + 'A' - 10);
+    } while (value != 0);
+    return write(str);
+}
+
+// SERIAL
+HardwareSerial Serial;
+
+namespace
+{
+const unsigned long long SERIAL_POLL_NANOS = 10000; // virtual time of a poll of an empty serial device
+
+int serialDevice = -1;     // PNL_SIM_SERIAL file descriptor
+bool serialHungUp = false; // the other end of PNL_SIM_SERIAL closed
+
+#ifndef PNL_SIM_NO_MAIN
+/**
+ * @brief Open PNL_SIM_SERIAL in raw mode, if set.
+ *
+ * @return true if the serial port is a host device
+ */
+bool openSerialDevice()
+{
+    const char *path = getenv("PNL_SIM_SERIAL");
+    if (path == nullptr)
+    {
+        return false;
+    }
+    serialDevice = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (serialDevice < 0)
+    {
+        fprintf(stderr, "cannot open serial device %s\n", path);
+        exit(1);
+    }
+    termios settings{};
+    if (tcgetattr(serialDevice, &settings) == 0)
+    {
+        cfmakeraw(&settings);
+        tcsetattr(serialDevice, TCSANOW, &settings);
+    }
+    return true;
+}
+#endif
+
+/**
+ * @brief Move bytes received on PNL_SIM_SERIAL to the serial input. Polling an empty device takes virtual time,
+ * as waiting for the next byte would.
+ */
+void receiveSerialDevice()
+{
+    if (serialDevice < 0 || !simulator::board().serialInput.empty())
+    {
+        return;
+    }
+    byte buffer[256];
+    const ssize_t count = ::read(serialDevice, buffer, sizeof(buffer));
+    if (count > 0)
+    {
+        simulator::board().serialInput.insert(simulator::board().serialInput.end(), buffer, buffer + count);
+        return;
+    }
+    if (count == 0 || errno == EIO)
+    {
+        serialHungUp = true;
+    }
+    simulator::board().advance(SERIAL_POLL_NANOS);
+}
+} // namespace
+
+void HardwareSerial::begin(unsigned long /*baud*/)
+{
+}
+
+void HardwareSerial::end()
+{
+}
+
+int HardwareSerial::available()
+{
+    receiveSerialDevice();
+    return static_cast<int>(simulator::board().serialInput.size());
+}
+
+int HardwareSerial::peek()
+{
+    receiveSerialDevice();
+    return simulator::board().serialInput.empty() ? -1 : simulator::board().serialInput.front();
+}
+
+int HardwareSerial::read()
+{
+    const int value = peek();
+    if (value >= 0)
+    {
+        simulator::board().serialInput.pop_front();
+    }
+    return value;
+}
+
+size_t HardwareSerial::write(uint8_t value)
+{
+    if (serialDevice >= 0)
+    {
+        return write(&value, 1);
+    }
+    if (value != '\r')
+    {
+        fputc(value, stdout);
+    }
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *pBuffer, size_t size)
+{
+    if (serialDevice < 0)
+    {
+        return Print::write(pBuffer, size);
+    }
+    size_t written = 0;
+    while (written < size && !serialHungUp)
+    {
+        const ssize_t count = ::write(serialDevice, pBuffer + written, size - written);
+        if (count > 0)
+        {
+            written += count;
+        }
+        else if (errno != EAGAIN)
+        {
+            serialHungUp = true;
+        }
+    }
+    return written;
+}
+
+int HardwareSerial::availableForWrite()
+{
+    return 64;
+}
+
+void HardwareSerial::flush()
+{
+    fflush(stdout);
+}
+
+// PINS
+void pinMode(uint8_t /*pin*/, uint8_t /*mode*/)
+{
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    simulator::board().pinWrite(pin, value);
+}
+
+int digitalRead(uint8_t pin)
+{
+    return simulator::board().pinRead(pin);
+}
+
+// INTERRUPTS
+void interrupts()
+{
+    simulator::board().setInterruptsEnabled(true);
+}
+
+void noInterrupts()
+{
+    simulator::board().setInterruptsEnabled(false);
+}
+
+// TIME
+unsigned long millis()
+{
+    return static_cast<unsigned long>(simulator::board().nanos() / 1000000ULL);
+}
+
+unsigned long micros()
+{
+    return static_cast<unsigned long>(simulator::board().nanos() / 1000ULL);
+}
+
+void delay(unsigned long ms)
+{
+    simulator::board().advance(ms * 1000000ULL);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    simulator::board().advance(us * 1000ULL);
+}
+
+void yield()
+{
+}
+
+// SPI
+SPIClass SPI;
+
+void SPIClass::begin()
+{
+}
+
+void SPIClass::end()
+{
+}
+
+void SPIClass::beginTransaction(SPISettings /*settings*/)
+{
+}
+
+void SPIClass::endTransaction()
+{
+}
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+    return simulator::board().spiTransfer(data);
+}
+
+uint16_t SPIClass::transfer16(uint16_t data)
+{
+    const uint8_t high = transfer(data >> 8);
+    return static_cast<uint16_t>(high << 8 | transfer(data & 0xFF));
+}
+
+void SPIClass::transfer(void *pBuffer, size_t count)
+{
+    auto *data = static_cast<uint8_t *>(pBuffer);
+    while (count-- > 0)
+    {
+        *data = transfer(*data);
+        data++;
+    }
+}
+
+void SPIClass::usingInterrupt(uint8_t /*interruptNumber*/)
+{
+}
+
+// MAIN
+#ifndef PNL_SIM_NO_MAIN
+int main()
+{
+    const char *loops = getenv("PNL_SIM_LOOPS");
+    const bool device = openSerialDevice();
+    const long count = loops != nullptr ? atol(loops) : (device ? -1 : 1); // until hang up
+
+    setup();
+    for (long i = 0; (count < 0 || i < count) && !serialHungUp; i++)
+    {
+        loop();
+    }
+    fflush(stdout);
+
+    simulator::board().counters.print(stderr, "total");
+
+    const char *snapshot = getenv("PNL_SIM_SNAPSHOT");
+    if (snapshot != nullptr && !simulator::board().display.writeSnapshot(snapshot))
+    {
+        fprintf(stderr, "cannot write snapshot %s\n", snapshot);
+        return 1;
+    }
+
+    const char *golden = getenv("PNL_SIM_GOLDEN");
+    if (golden != nullptr && !simulator::board().display.matchesSnapshot(golden))
+    {
+        fprintf(stderr, "display differs from %s\n", golden);
+        return 1;
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,104 @@
+/**
+ * @file Arduino.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Host-side replacement of the Arduino core for the PNL CE02 simulator.
+ *
+ * Pins, SPI and time are routed to the simulated board (refer to Epson_PNL_CE02_Simulator.h).
+ * Time is virtual: it only advances with `delay()` and with the modeled bus activity.
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_SIMULATOR_ARDUINO_H
+#define EPSON_PNL_CE02_SIMULATOR_ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Print.h"
+#include "Stream.h"
+
+#define EPSON_PNL_CE02_SIMULATOR 1
+
+typedef uint8_t byte;  // NOLINT(modernize-use-using): Arduino API type
+typedef bool boolean;  // NOLINT(modernize-use-using): Arduino API type
+typedef uint16_t word; // NOLINT(modernize-use-using): Arduino API type
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+#define pgm_read_byte(addr) (*reinterpret_cast<const uint8_t *>(addr))
+#define pgm_read_word(addr) (*reinterpret_cast<const uint16_t *>(addr))
+#define pgm_read_dword(addr) (*reinterpret_cast<const uint32_t *>(addr))
+#define pgm_read_ptr(addr) (*reinterpret_cast<const void *const *>(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+#define bit(b) (1UL << (b))
+#define bitRead(value, b) (((value) >> (b)) & 0x01)
+#define bitSet(value, b) ((value) |= (1UL << (b)))
+#define bitClear(value, b) ((value) &= ~(1UL << (b)))
+#define bitWrite(value, b, bitvalue) ((bitvalue) ? bitSet(value, b) : bitClear(value, b))
+#define lowByte(w) ((uint8_t)((w)&0xff))
+#define highByte(w) ((uint8_t)((w) >> 8))
+
+void interrupts();
+void noInterrupts();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+/**
+ * @brief Serial port printing to the host standard output.
+ * Input can be fed from the simulator (refer to simulator::Board::serialInput).
+ * With PNL_SIM_SERIAL, the serial port is a host serial device instead, e.g. a pseudo-terminal.
+ */
+class HardwareSerial : public Stream
+{
+  public:
+    void begin(unsigned long baud);
+    void end();
+    int available() override;
+    int peek() override;
+    int read() override;
+    size_t write(uint8_t value) override;
+    size_t write(const uint8_t *pBuffer, size_t size) override;
+    int availableForWrite() override;
+    void flush() override;
+    explicit operator bool() const
+    {
+        return true;
+    }
+    using Print::write;
+};
+
+extern HardwareSerial Serial; // NOLINT(readability-identifier-naming): Arduino API name
+
+void setup();
+void loop();
+
+#endif // EPSON_PNL_CE02_SIMULATOR_ARDUINO_H
@@ -0,0 +1,521 @@
+/**
+ * @file Epson_PNL_CE02_Simulator.cpp
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Host-side, bit-accurate simulator of the control panel (PNL CE02).
+ *
+ * @copyright MIT license
+ */
+
+#include "Epson_PNL_CE02_Simulator.h"
+
+#include <algorithm>
+
+namespace simulator
+{
+
+// COUNTERS
+Counters Counters::operator-(const Counters &other) const
+{
+    Counters diff;
+    diff.spiBytes = spiBytes - other.spiBytes;
+    diff.latchEdges = latchEdges - other.latchEdges;
+    diff.wrStrobes = wrStrobes - other.wrStrobes;
+    diff.dcToggles = dcToggles - other.dcToggles;
+    diff.csToggles = csToggles - other.csToggles;
+    diff.pinWrites = pinWrites - other.pinWrites;
+    diff.displayCommands = displayCommands - other.displayCommands;
+    diff.displayData = displayData - other.displayData;
+    diff.busNanos = busNanos - other.busNanos;
+    return diff;
+}
+
+void Counters::print(FILE *pOut, const char *pLabel) const
+{
+    fprintf(pOut, "%s spi=%lu latch=%lu wr=%lu dc=%lu cs=%lu pins=%lu cmd=%lu data=%lu bus_us=%llu\n", pLabel, spiBytes,
+            latchEdges, wrStrobes, dcToggles, csToggles, pinWrites, displayCommands, displayData, busNanos / 1000);
+}
+
+// SHIFT REGISTERS
+void ShiftRegister595::clock(bool serialIn)
+{
+    shift = static_cast<byte>((shift << 1) | (serialIn ? 1 : 0));
+}
+
+void ShiftRegister595::latch()
+{
+    storage = shift;
+}
+
+void ShiftRegister164::clock(bool serialIn)
+{
+    value = static_cast<byte>((value << 1) | (serialIn ? 1 : 0));
+}
+
+void ShiftRegister165::setLoad(bool load, byte inputs)
+{
+    loading = load;
+    shift = inputs; // load is asynchronous, the register keeps the last loaded inputs
+}
+
+bool ShiftRegister165::output(byte inputs) const
+{
+    return ((loading ? inputs : shift) & 0x80) != 0; // Q7 (H)
+}
+
+void ShiftRegister165::clock(byte inputs)
+{
+    if (loading)
+    {
+        shift = inputs; // clock is ignored while SH/LD is LOW
+        return;
+    }
+    shift = static_cast<byte>((shift << 1) | 1); // DS tied HIGH
+}
+
+// DISPLAY CONTROLLER
+namespace
+{
+const byte SWRESET = 0x01;
+const byte SLPIN = 0x10;
+const byte SLPOUT = 0x11;
+const byte DISPOFF = 0x28;
+const byte DISPON = 0x29;
+const byte CASET = 0x2A;
+const byte RASET = 0x2B;
+const byte RAMWR = 0x2C;
+const byte VSCRDEF = 0x33;
+const byte MADCTL = 0x36;
+const byte VSCRSADD = 0x37;
+const byte COLMOD = 0x3A;
+
+const byte MADCTL_MY = 0x80;
+const byte MADCTL_MX = 0x40;
+const byte MADCTL_MV = 0x20;
+
+const byte COLMOD_12BIT = 0x03;
+const byte COLMOD_16BIT = 0x05;
+
+uint16_t rgb444To565(byte red, byte green, byte blue)
+{
+    return static_cast<uint16_t>(((red << 1 | red >> 3) << 11) | ((green << 2 | green >> 2) << 5) |
+                                 (blue << 1 | blue >> 3));
+}
+} // namespace
+
+DisplayController::DisplayController() : gram(WIDTH * HEIGHT, 0)
+{
+}
+
+void DisplayController::reset()
+{
+    command = 0;
+    paramCount = 0;
+    pixelCount = 0;
+    xs = 0;
+    xe = WIDTH - 1;
+    ys = 0;
+    ye = HEIGHT - 1;
+    x = 0;
+    y = 0;
+    madctl = 0;
+    colmod = 0x06;
+    sleeping = true;
+    displayOn = false;
+    tfa = 0;
+    vsa = HEIGHT;
+    bfa = 0;
+    ssa = 0;
+}
+
+void DisplayController::write(byte value, bool data)
+{
+    if (!data)
+    {
+        command = value;
+        paramCount = 0;
+        pixelCount = 0;
+        switch (command)
+        {
+        case SWRESET:
+            reset();
+            break;
+        case SLPIN:
+            sleeping = true;
+            break;
+        case SLPOUT:
+            sleeping = false;
+            break;
+        case DISPOFF:
+            displayOn = false;
+            break;
+        case DISPON:
+            displayOn = true;
+            break;
+        case RAMWR:
+            x = xs;
+            y = ys;
+            break;
+        default:
+            break;
+        }
+        return;
+    }
+
+    if (command == RAMWR)
+    {
+        pixelByte(value);
+        return;
+    }
+    parameter(value);
+}
+
+void DisplayController::parameter(byte value)
+{
+    if (paramCount < static_cast<int>(sizeof(params)))
+    {
+        params[paramCount] = value;
+    }
+    paramCount++;
+
+    switch (command)
+    {
+    case CASET:
+        if (paramCount == 4)
+        {
+            xs = params[0] << 8 | params[1];
+            xe = params[2] << 8 | params[3];
+        }
+        break;
+    case RASET:
+        if (paramCount == 4)
+        {
+            ys = params[0] << 8 | params[1];
+            ye = params[2] << 8 | params[3];
+        }
+        break;
+    case MADCTL:
+        madctl = value;
+        break;
+    case COLMOD:
+        colmod = value & 0x07;
+        break;
+    case VSCRDEF:
+        if (paramCount == 6)
+        {
+            tfa = params[0] << 8 | params[1];
+            vsa = params[2] << 8 | params[3];
+            bfa = params[4] << 8 | params[5];
+        }
+        break;
+    case VSCRSADD:
+        if (paramCount == 2)
+        {
+            ssa = params[0] << 8 | params[1];
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void DisplayController::pixelByte(byte value)
+{
+    pixelBytes[pixelCount++] = value;
+
+    if (colmod == COLMOD_16BIT)
+    {
+        if (pixelCount == 2)
+        {
+            pushPixel(static_cast<uint16_t>(pixelBytes[0] << 8 | pixelBytes[1]));
+            pixelCount = 0;
+        }
+    }
+    else if (colmod == COLMOD_12BIT)
+    {
+        // 3 bytes for 2 pixels: R1G1 B1R2 G2B2, a pixel is written once its 12 bits are received
+        if (pixelCount == 2)
+        {
+            pushPixel(rgb444To565(pixelBytes[0] >> 4, pixelBytes[0] & 0x0F, pixelBytes[1] >> 4));
+        }
+        else if (pixelCount == 3)
+        {
+            pushPixel(rgb444To565(pixelBytes[1] & 0x0F, pixelBytes[2] >> 4, pixelBytes[2] & 0x0F));
+            pixelCount = 0;
+        }
+    }
+    else if (pixelCount == 3) // 18-bit, 6 MSB of each byte
+    {
+        pushPixel(static_cast<uint16_t>((pixelBytes[0] >> 3) << 11 | (pixelBytes[1] >> 2) << 5 | pixelBytes[2] >> 3));
+        pixelCount = 0;
+    }
+}
+
+void DisplayController::pushPixel(uint16_t color)
+{
+    int column = x;
+    int row = y;
+    if ((madctl & MADCTL_MV) != 0)
+    {
+        column = y;
+        row = x;
+    }
+    if ((madctl & MADCTL_MX) != 0)
+    {
+        column = WIDTH - 1 - column;
+    }
+    if ((madctl & MADCTL_MY) != 0)
+    {
+        row = HEIGHT - 1 - row;
+    }
+    if (column >= 0 && column < WIDTH && row >= 0 && row < HEIGHT)
+    {
+        gram[row * WIDTH + column] = color;
+    }
+
+    if (++x > xe)
+    {
+        x = xs;
+        if (++y > ye)
+        {
+            y = ys;
+        }
+    }
+}
+
+uint16_t DisplayController::memory(int column, int row) const
+{
+    return gram[row * WIDTH + column];
+}
+
+uint16_t DisplayController::pixel(int column, int row) const
+{
+    int memoryRow = row;
+    if (vsa > 0 && row >= tfa && row < tfa + vsa)
+    {
+        memoryRow = tfa + ((row - tfa) + (ssa - tfa) + vsa) % vsa;
+    }
+    if (memoryRow < 0 || memoryRow >= HEIGHT)
+    {
+        return 0;
+    }
+    return memory(column, memoryRow);
+}
+
+std::vector<byte> DisplayController::snapshot() const
+{
+    char header[32];
+    const int headerSize = snprintf(header, sizeof(header), "P6\n%d %d\n255\n", WIDTH, HEIGHT);
+    std::vector<byte> ppm(header, header + headerSize);
+    for (int row = 0; row < HEIGHT; row++)
+    {
+        for (int column = 0; column < WIDTH; column++)
+        {
+            const uint16_t color = pixel(column, row);
+            const byte red = color >> 11;
+            const byte green = (color >> 5) & 0x3F;
+            const byte blue = color & 0x1F;
+            ppm.push_back(static_cast<byte>(red << 3 | red >> 2));
+            ppm.push_back(static_cast<byte>(green << 2 | green >> 4));
+            ppm.push_back(static_cast<byte>(blue << 3 | blue >> 2));
+        }
+    }
+    return ppm;
+}
+
+bool DisplayController::writeSnapshot(const char *pPath) const
+{
+    FILE *file = fopen(pPath, "wb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    const std::vector<byte> ppm = snapshot();
+    const bool written = fwrite(ppm.data(), 1, ppm.size(), file) == ppm.size();
+    return fclose(file) == 0 && written;
+}
+
+bool DisplayController::matchesSnapshot(const char *pPath) const
+{
+    FILE *file = fopen(pPath, "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    const std::vector<byte> ppm = snapshot();
+    std::vector<byte> golden(ppm.size() + 1);
+    const size_t read = fread(golden.data(), 1, golden.size(), file);
+    fclose(file);
+    return read == ppm.size() && std::equal(ppm.begin(), ppm.end(), golden.begin());
+}
+
+// BOARD
+Board::Board() : levels(256, HIGH)
+{
+}
+
+void Board::wire(const Epson_PNL_CE02_Pinout &pinout)
+{
+    latchPin = pinout.LATCH;
+    writePin = pinout.LCD_WRITE;
+    resetPin = pinout.LCD_RESET;
+    powerPin = pinout.POWER_BUTTON;
+}
+
+void Board::setButtons(byte buttons)
+{
+    pressed = buttons;
+}
+
+void Board::scheduleButtons(unsigned long atMillis, byte buttons)
+{
+    schedule.push_back({atMillis * 1000000ULL, buttons});
+}
+
+void Board::setPowerButton(bool buttonPressed)
+{
+    powerPressed = buttonPressed;
+}
+
+void Board::pinWrite(uint8_t pin, uint8_t value)
+{
+    counters.pinWrites++;
+    advance(timing.pinWriteNanos);
+
+    const uint8_t previous = levels[pin];
+    levels[pin] = value == LOW ? LOW : HIGH;
+    if (previous == levels[pin])
+    {
+        return;
+    }
+
+    if (pin == latchPin)
+    {
+        onLatch(levels[pin] == HIGH);
+    }
+    else if (pin == writePin && levels[pin] == HIGH)
+    {
+        onWrite();
+    }
+    else if (pin == resetPin && levels[pin] == LOW)
+    {
+        display.reset();
+    }
+}
+
+int Board::pinRead(uint8_t pin)
+{
+    if (pin == powerPin)
+    {
+        return powerPressed ? LOW : HIGH; // pull-up, button to GND
+    }
+    return levels[pin];
+}
+
+byte Board::spiTransfer(byte out)
+{
+    counters.spiBytes++;
+    advance(timing.spiByteNanos);
+
+    byte in = 0;
+    for (int bit = 7; bit >= 0; bit--)
+    {
+        const bool mosi = ((out >> bit) & 1) != 0;
+        in = static_cast<byte>((in << 1) | (buttons.output(inputs()) ? 1 : 0)); // sampled on rising edge
+        extender.clock(mosi);
+        data.clock(mosi);
+        buttons.clock(inputs());
+    }
+    return in;
+}
+
+void Board::advance(unsigned long long nanos)
+{
+    now += nanos;
+    counters.busNanos += nanos;
+    while (!schedule.empty() && schedule.front().at <= now)
+    {
+        pressed = schedule.front().pressed;
+        schedule.pop_front();
+    }
+    serviceTimer();
+}
+
+void Board::setTimerInterrupt(unsigned long periodMicros, void (*pHandler)())
+{
+    timerHandler = pHandler;
+    timerPeriod = periodMicros * 1000ULL;
+    timerNext = now + timerPeriod;
+}
+
+void Board::setInterruptsEnabled(bool enabled)
+{
+    interruptsEnabled = enabled;
+    serviceTimer();
+}
+
+void Board::serviceTimer()
+{
+    if (timerHandler == nullptr || timerPeriod == 0 || !interruptsEnabled || inInterrupt || now < timerNext)
+    {
+        return;
+    }
+    while (timerNext <= now)
+    {
+        timerNext += timerPeriod; // missed periods are merged, as the interrupt flag is
+    }
+    inInterrupt = true;
+    timerHandler();
+    inInterrupt = false;
+}
+
+void Board::onLatch(bool high)
+{
+    if (!high)
+    {
+        buttons.setLoad(true, inputs());
+        return;
+    }
+
+    counters.latchEdges++;
+    const byte previous = extender.storage;
+    extender.latch();
+    buttons.setLoad(false, inputs());
+
+    const byte changed = previous ^ extender.storage;
+    if (bitRead(changed, static_cast<byte>(ExtenderPin::LCD_DC)) != 0)
+    {
+        counters.dcToggles++;
+    }
+    if (bitRead(changed, static_cast<byte>(ExtenderPin::LCD_CS)) != 0)
+    {
+        counters.csToggles++;
+    }
+}
+
+void Board::onWrite()
+{
+    counters.wrStrobes++;
+    if (bitRead(extender.storage, static_cast<byte>(ExtenderPin::LCD_CS)) != 0)
+    {
+        return; // chip select is active LOW
+    }
+
+    const bool isData = bitRead(extender.storage, static_cast<byte>(ExtenderPin::LCD_DC)) != 0;
+    if (isData)
+    {
+        counters.displayData++;
+    }
+    else
+    {
+        counters.displayCommands++;
+    }
+    display.write(data.value, isData);
+}
+
+Board &board()
+{
+    static Board instance;
+    return instance;
+}
+
+} // namespace simulator
@@ -0,0 +1,298 @@
+/**
+ * @file Epson_PNL_CE02_Simulator.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Host-side, bit-accurate simulator of the control panel (PNL CE02).
+ *
+ * Models the board as wired on the FFC:
+ *  => 74HC595 extender latched by LATCH (refer to ExtenderPin)
+ *  => non-latched 74HC164 driving D0-D7 of an ILI9163C (128x128 RGB565 framebuffer), strobed by LCD_WRITE
+ *  => 74LV165A buttons register loaded by LATCH (LOW: parallel load, HIGH: shift)
+ *
+ * All of them share the SPI clock and the SPI MOSI line, the 74LV165A drives SPI MISO.
+ * Bus activity is accounted in Counters, use `simulator::measure()` to get the cost of a call:
+ * ``` c++
+ * simulator::Counters cost = simulator::measure([] { controlPanel.extenderWrite(ExtenderPin::LCD_DC, HIGH); });
+ * cost.print(stdout, "extenderWrite");
+ * ```
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_SIMULATOR_H
+#define EPSON_PNL_CE02_SIMULATOR_H
+
+#include <Arduino.h>
+#include <Epson_PNL_CE02.h>
+
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+namespace simulator
+{
+
+/**
+ * @brief Bus activity counters.
+ */
+struct Counters
+{
+    unsigned long spiBytes{0};         // bytes clocked on the shared SPI bus
+    unsigned long latchEdges{0};       // LATCH rising edges (74HC595 storage updates)
+    unsigned long wrStrobes{0};        // LCD_WRITE rising edges
+    unsigned long dcToggles{0};        // latched LCD_DC changes
+    unsigned long csToggles{0};        // latched LCD_CS changes
+    unsigned long pinWrites{0};        // digitalWrite calls
+    unsigned long displayCommands{0};  // command bytes received by the display
+    unsigned long displayData{0};      // data bytes received by the display
+    unsigned long long busNanos{0};    // modeled bus time (refer to Timing)
+
+    Counters operator-(const Counters &other) const;
+
+    /**
+     * @brief Print counters on a single machine readable line.
+     *
+     * @param pOut output stream
+     * @param pLabel line label
+     */
+    void print(FILE *pOut, const char *pLabel) const;
+};
+
+/**
+ * @brief Bus timing model, used to advance the virtual clock.
+ */
+struct Timing
+{
+    unsigned long spiByteNanos{1000}; // 8 bits at F_CPU / 2
+    unsigned long pinWriteNanos{250};
+};
+
+/**
+ * @brief 74HC595, serial in, latched parallel out.
+ */
+class ShiftRegister595
+{
+  public:
+    void clock(bool serialIn);
+    void latch();
+    byte shift{0};
+    byte storage{0};
+};
+
+/**
+ * @brief 74HC164, serial in, non-latched parallel out.
+ */
+class ShiftRegister164
+{
+  public:
+    void clock(bool serialIn);
+    byte value{0};
+};
+
+/**
+ * @brief 74LV165A, parallel in (buttons, active LOW), serial out.
+ */
+class ShiftRegister165
+{
+  public:
+    void setLoad(bool load, byte inputs);
+    bool output(byte inputs) const;
+    void clock(byte inputs);
+
+  private:
+    bool loading{false};
+    byte shift{0xFF};
+};
+
+/**
+ * @brief ILI9163C, 8-bit parallel write-only interface.
+ */
+class DisplayController
+{
+  public:
+    static const int WIDTH = 128;
+    static const int HEIGHT = 128;
+
+    DisplayController();
+
+    /**
+     * @brief Hardware reset, registers back to their default values.
+     */
+    void reset();
+
+    /**
+     * @brief Receive a byte on WR rising edge.
+     *
+     * @param value D0-D7
+     * @param data D/C pin (false: command, true: data)
+     */
+    void write(byte value, bool data);
+
+    /**
+     * @brief Pixel as seen on the panel (vertical scrolling applied).
+     */
+    uint16_t pixel(int x, int y) const;
+
+    /**
+     * @brief Pixel as stored in the frame memory.
+     */
+    uint16_t memory(int x, int y) const;
+
+    /**
+     * @brief Write the panel content to a binary PPM (P6) file.
+     *
+     * @return true on success
+     */
+    bool writeSnapshot(const char *pPath) const;
+
+    /**
+     * @brief Compare the panel content with a PPM file written by writeSnapshot().
+     *
+     * @return true if identical
+     */
+    bool matchesSnapshot(const char *pPath) const;
+
+    byte colorMode() const
+    {
+        return colmod;
+    }
+    bool isDisplayOn() const
+    {
+        return displayOn;
+    }
+    bool isSleeping() const
+    {
+        return sleeping;
+    }
+
+  private:
+    std::vector<uint16_t> gram;
+    byte command{0};
+    byte params[8]{};
+    int paramCount{0};
+    byte pixelBytes[3]{};
+    int pixelCount{0};
+    int xs{0}, xe{WIDTH - 1}, ys{0}, ye{HEIGHT - 1}, x{0}, y{0};
+    byte madctl{0};
+    byte colmod{0x06};
+    bool sleeping{true};
+    bool displayOn{false};
+    int tfa{0}, vsa{HEIGHT}, bfa{0}, ssa{0};
+
+    void parameter(byte value);
+    void pixelByte(byte value);
+    void pushPixel(uint16_t color);
+    std::vector<byte> snapshot() const;
+};
+
+/**
+ * @brief The simulated control panel wired to the simulated Arduino.
+ */
+class Board
+{
+  public:
+    Board();
+
+    /**
+     * @brief Use the pinout given to Epson_PNL_CE02 (defaults to the README pinout).
+     */
+    void wire(const Epson_PNL_CE02_Pinout &pinout);
+
+    /**
+     * @brief Set currently pressed buttons (refer to ButtonMask).
+     */
+    void setButtons(byte pressed);
+
+    /**
+     * @brief Press buttons at a given virtual time, for scripted scenarios.
+     *
+     * @param atMillis virtual time
+     * @param pressed buttons pressed from this time (refer to ButtonMask)
+     */
+    void scheduleButtons(unsigned long atMillis, byte pressed);
+
+    /**
+     * @brief Set the state of the dedicated power button.
+     */
+    void setPowerButton(bool pressed);
+
+    /**
+     * @brief Call a handler periodically on the virtual clock, as a timer interrupt would:
+     * before a bus access or during a delay, never nested, held while interrupts are disabled.
+     *
+     * @param periodMicros virtual period
+     * @param pHandler interrupt handler, nullptr to stop
+     */
+    void setTimerInterrupt(unsigned long periodMicros, void (*pHandler)());
+
+    // Arduino core hooks
+    void setInterruptsEnabled(bool enabled);
+    void pinWrite(uint8_t pin, uint8_t value);
+    int pinRead(uint8_t pin);
+    byte spiTransfer(byte out);
+    void advance(unsigned long long nanos);
+
+    unsigned long long nanos() const
+    {
+        return now;
+    }
+
+    ShiftRegister595 extender;
+    ShiftRegister164 data;
+    ShiftRegister165 buttons;
+    DisplayController display;
+    Counters counters;
+    Timing timing;
+    std::deque<byte> serialInput;
+
+  private:
+    struct ScheduledButtons
+    {
+        unsigned long long at;
+        byte pressed;
+    };
+
+    byte latchPin{48};
+    byte writePin{49};
+    byte resetPin{47};
+    byte powerPin{46};
+    std::deque<ScheduledButtons> schedule;
+    void (*timerHandler)(){nullptr};
+    unsigned long long timerPeriod{0};
+    unsigned long long timerNext{0};
+    bool interruptsEnabled{true};
+    bool inInterrupt{false};
+    std::vector<uint8_t> levels;
+    byte pressed{0};
+    bool powerPressed{false};
+    unsigned long long now{0};
+
+    byte inputs() const
+    {
+        return static_cast<byte>(~pressed); // pressed buttons pull 74LV165A inputs LOW
+    }
+    void onLatch(bool high);
+    void onWrite();
+    void serviceTimer();
+};
+
+/**
+ * @brief The simulated board used by the Arduino core replacement.
+ */
+Board &board();
+
+/**
+ * @brief Measure bus activity of a call.
+ *
+ * @param fn callable
+ * @return Counters activity during the call
+ */
+template <class Fn> Counters measure(Fn fn)
+{
+    const Counters before = board().counters;
+    fn();
+    return board().counters - before;
+}
+
+} // namespace simulator
+
+#endif // EPSON_PNL_CE02_SIMULATOR_H
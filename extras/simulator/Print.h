@@ -0,0 +1,74 @@
+/**
+ * @file Print.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Host-side replacement of the Arduino Print class for the PNL CE02 simulator.
+ *
+ * Only the subset used by the library and its examples is provided.
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_SIMULATOR_PRINT_H
+#define EPSON_PNL_CE02_SIMULATOR_PRINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class __FlashStringHelper; // NOLINT(bugprone-reserved-identifier): Arduino API name
+
+class Print
+{
+  public:
+    virtual ~Print() = default;
+
+    virtual size_t write(uint8_t value) = 0;
+    virtual size_t write(const uint8_t *pBuffer, size_t size);
+    size_t write(const char *pStr)
+    {
+        return pStr == nullptr ? 0 : write(reinterpret_cast<const uint8_t *>(pStr), strlen(pStr));
+    }
+    size_t write(const char *pBuffer, size_t size)
+    {
+        return write(reinterpret_cast<const uint8_t *>(pBuffer), size);
+    }
+
+    virtual int availableForWrite()
+    {
+        return 0;
+    }
+    virtual void flush()
+    {
+    }
+
+    size_t print(const __FlashStringHelper *pStr);
+    size_t print(const char *pStr);
+    size_t print(char value);
+    size_t print(unsigned char value, int base = DEC);
+    size_t print(int value, int base = DEC);
+    size_t print(unsigned int value, int base = DEC);
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    size_t println(const __FlashStringHelper *pStr);
+    size_t println(const char *pStr);
+    size_t println(char value);
+    size_t println(unsigned char value, int base = DEC);
+    size_t println(int value, int base = DEC);
+    size_t println(unsigned int value, int base = DEC);
+    size_t println(long value, int base = DEC);
+    size_t println(unsigned long value, int base = DEC);
+    size_t println(double value, int digits = 2);
+    size_t println();
+
+  private:
+    size_t printNumber(unsigned long value, int base);
+};
+
+#endif // EPSON_PNL_CE02_SIMULATOR_PRINT_H
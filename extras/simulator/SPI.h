@@ -0,0 +1,49 @@
+/**
+ * @file SPI.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Host-side replacement of the Arduino SPI library for the PNL CE02 simulator.
+ *
+ * Every byte is clocked bit by bit through the simulated shift registers.
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_SIMULATOR_SPI_H
+#define EPSON_PNL_CE02_SIMULATOR_SPI_H
+
+#include <Arduino.h>
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+class SPISettings
+{
+  public:
+    SPISettings() = default;
+    SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) : clock(clock), bitOrder(bitOrder), dataMode(dataMode)
+    {
+    }
+
+    uint32_t clock{4000000};
+    uint8_t bitOrder{MSBFIRST};
+    uint8_t dataMode{SPI_MODE0};
+};
+
+class SPIClass
+{
+  public:
+    static void begin();
+    static void end();
+    static void beginTransaction(SPISettings settings);
+    static void endTransaction();
+    static uint8_t transfer(uint8_t data);
+    static uint16_t transfer16(uint16_t data);
+    static void transfer(void *pBuffer, size_t count);
+    static void usingInterrupt(uint8_t interruptNumber);
+};
+
+extern SPIClass SPI; // NOLINT(readability-identifier-naming): Arduino API name
+
+#endif // EPSON_PNL_CE02_SIMULATOR_SPI_H
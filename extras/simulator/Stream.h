@@ -0,0 +1,24 @@
+/**
+ * @file Stream.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Host-side replacement of the Arduino Stream class for the PNL CE02 simulator.
+ *
+ * Only the subset used by the library and its examples is provided.
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_SIMULATOR_STREAM_H
+#define EPSON_PNL_CE02_SIMULATOR_STREAM_H
+
+#include "Print.h"
+
+class Stream : public Print
+{
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+#endif // EPSON_PNL_CE02_SIMULATOR_STREAM_H
@@ -1,8 +0,0 @@
-18c18
-< //#define SUPPORT_9163              //
----
-> #define SUPPORT_9163              //
-2227c2227
-<         *p16 = 160;
----
->         *p16 = 128;
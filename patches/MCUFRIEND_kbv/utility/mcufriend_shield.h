@@ -1,4 +0,0 @@
-1c1
-< //#define USE_SPECIAL             //check for custom drivers
----
-> #define USE_SPECIAL             //check for custom drivers
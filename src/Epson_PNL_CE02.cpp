@@ -73,8 +73,80 @@ bool isButtonPressed(byte sequence, ButtonMask mask)
     return (sequence & static_cast<byte>(mask)) != 0; // Check if key pressed 0000{key}000, key>0 if set
 }
 
+// cppcheck-suppress unusedFunction
+byte extenderMask(ExtenderPin pin)
+{
+    return bit(static_cast<byte>(pin));
+}
+
+#if defined(EPSON_PNL_CE02_STATS)
+void Epson_PNL_CE02_Timing::record(uint32_t duration)
+{
+    if (count == 0 || duration < minimum)
+    {
+        minimum = duration;
+    }
+    if (duration > maximum)
+    {
+        maximum = duration;
+    }
+    count++;
+
+    byte index = 0;
+    uint32_t limit = 4;
+    while (index < BUCKETS - 1 && duration >= limit)
+    {
+        index++;
+        limit <<= 2;
+    }
+    buckets[index]++;
+}
+
+namespace
+{
+/**
+ * @brief Print a timing on two lines: count, minimum and maximum, then the histogram.
+ */
+void printTiming(Print &output, const __FlashStringHelper *pName, const Epson_PNL_CE02_Timing &timing)
+{
+    output.print(pName);
+    output.print(F(" (us): count="));
+    output.print(timing.count);
+    output.print(F(" min="));
+    output.print(timing.minimum);
+    output.print(F(" max="));
+    output.println(timing.maximum);
+
+    output.print(F("  histogram:"));
+    uint32_t limit = 4;
+    for (byte index = 0; index < Epson_PNL_CE02_Timing::BUCKETS; index++)
+    {
+        output.print(index < Epson_PNL_CE02_Timing::BUCKETS - 1 ? F(" <") : F(" >="));
+        output.print(index < Epson_PNL_CE02_Timing::BUCKETS - 1 ? limit : limit >> 2);
+        output.print(':');
+        output.print(timing.buckets[index]);
+        limit <<= 2;
+    }
+    output.println();
+}
+} // namespace
+#endif
+
+// STATICS
+byte Epson_PNL_CE02::shifted = 0b0;
+bool Epson_PNL_CE02::shiftedValid = false;
+volatile byte Epson_PNL_CE02::busDepth = 0;
+volatile bool Epson_PNL_CE02::busRequested = false;
+void (*volatile Epson_PNL_CE02::busHandler)() = nullptr;
+void (*volatile Epson_PNL_CE02::busSuspend)() = nullptr;
+void (*volatile Epson_PNL_CE02::busResume)() = nullptr;
+#if defined(EPSON_PNL_CE02_STATS)
+Epson_PNL_CE02_Stats Epson_PNL_CE02::statistics = {};
+#endif
+
 // CTOR
-Epson_PNL_CE02::Epson_PNL_CE02(Epson_PNL_CE02_Pinout *pPinout) : pins(pPinout)
+Epson_PNL_CE02::Epson_PNL_CE02(Epson_PNL_CE02_Pinout *pPinout)
+    : pins(pPinout), latchPin(pPinout->LATCH), writePin(pPinout->LCD_WRITE), powerPin(pPinout->POWER_BUTTON)
 {
 }
 
@@ -85,9 +157,12 @@ void Epson_PNL_CE02::begin() const
 
     pinMode(pins->EXTENDER_OE, OUTPUT);
     pinMode(pins->LATCH, OUTPUT);
+    digitalWrite(pins->LATCH, HIGH); // idle, 74LV165A in serial output mode
     pinMode(pins->CLOCK, OUTPUT);
     pinMode(pins->SERIAL_IN, OUTPUT);
     pinMode(pins->SERIAL_OUT, INPUT);
+    pinMode(pins->LCD_WRITE, OUTPUT);
+    digitalWrite(pins->LCD_WRITE, HIGH); // idle
 
     SPIClass::begin();
     SPIClass::beginTransaction(SPISettings(F_CPU / 2, MSBFIRST, SPI_MODE0)); // Max SPI speed
@@ -99,35 +174,451 @@ void Epson_PNL_CE02::begin() const
 void Epson_PNL_CE02::extenderWrite(ExtenderPin pin, byte mode)
 {
     bitWrite(buffer, (byte)pin, mode);
-    synchronize();
+    updateExtender();
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02::extenderWriteMask(byte mask, byte value)
+{
+    buffer = (buffer & ~mask) | (value & mask);
+    updateExtender();
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02::beginExtenderUpdate()
+{
+    updateDepth++;
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02::commitExtender()
+{
+    if (updateDepth > 0)
+    {
+        updateDepth--;
+    }
+    updateExtender();
 }
 
 // cppcheck-suppress unusedFunction
 void Epson_PNL_CE02::displayWrite(byte data)
 {
+    const BusOwner owner;
+    shiftedValid = false;
     SPIClass::transfer(data);
+#if defined(EPSON_PNL_CE02_STATS)
+    statistics.displayBytes++;
+#endif
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02::displayReset() const
+{
+    const unsigned int RESET_PULSE_US = 10;
+    pinMode(pins->LCD_RESET, OUTPUT);
+    digitalWrite(pins->LCD_RESET, LOW);
+    delayMicroseconds(RESET_PULSE_US);
+    digitalWrite(pins->LCD_RESET, HIGH);
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02::displayWriteBuffer(const byte *pData, size_t length) const
+{
+    displayStream(length, [&pData]() { return *pData++; });
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02::displayWriteBuffer_P(const byte *pData, size_t length) const
+{
+    displayStream(length, [&pData]() { return static_cast<byte>(pgm_read_byte(pData++)); });
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02::displayWritePixels(const uint16_t *pPixels, size_t count) const
+{
+    uint16_t pixel = 0;
+    bool highSent = false;
+    displayStream(count * 2, [&pPixels, &pixel, &highSent]() {
+        highSent = !highSent;
+        if (highSent)
+        {
+            pixel = *pPixels++;
+            return static_cast<byte>(pixel >> 8);
+        }
+        return static_cast<byte>(pixel);
+    });
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02::displayWritePixels_P(const uint16_t *pPixels, size_t count) const
+{
+    uint16_t pixel = 0;
+    bool highSent = false;
+    displayStream(count * 2, [&pPixels, &pixel, &highSent]() {
+        highSent = !highSent;
+        if (highSent)
+        {
+            pixel = pgm_read_word(pPixels++);
+            return static_cast<byte>(pixel >> 8);
+        }
+        return static_cast<byte>(pixel);
+    });
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02::displayWriteIndexed_P(const byte *pIndexes, byte bits, const byte *pPalette, size_t count) const
+{
+    byte packed = 0;
+    byte left = 0; // indexes left in `packed`
+    byte low = 0;
+    bool highSent = false;
+    displayStream(count * 2, [&pIndexes, bits, pPalette, &packed, &left, &low, &highSent]() {
+        highSent = !highSent;
+        if (!highSent)
+        {
+            return low;
+        }
+        if (left == 0)
+        {
+            packed = pgm_read_byte(pIndexes++);
+            left = 8 / bits;
+        }
+        const byte *pColor = pPalette + 2 * (packed >> (8 - bits));
+        packed <<= bits;
+        left--;
+        low = pgm_read_byte(pColor + 1);
+        return static_cast<byte>(pgm_read_byte(pColor));
+    });
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02::displayRepeat(byte value, uint32_t count) const
+{
+    const byte CHUNK = 0xFF; // strobes between two bus handler checks
+    if (count == 0)
+    {
+        return;
+    }
+
+    const BusOwner owner;
+#if defined(EPSON_PNL_CE02_STATS)
+    const uint32_t start = micros();
+    statistics.displayBytes++;
+    statistics.writeStrobes += count;
+#endif
+    shiftedValid = false;
+    SPIClass::transfer(value); // held by the non latched 74HC164
+    while (count > 0)
+    {
+        byte chunk = count > CHUNK ? CHUNK : count;
+        count -= chunk;
+        while (chunk-- > 0)
+        {
+            displayStrobe();
+        }
+        if (busRequested)
+        {
+            serviceBus();
+            shiftedValid = false;
+            SPIClass::transfer(value); // the handler replaced the 74HC164 content
+#if defined(EPSON_PNL_CE02_STATS)
+            statistics.displayBytes++;
+#endif
+        }
+    }
+#if defined(EPSON_PNL_CE02_STATS)
+    statistics.displayBursts.record(micros() - start);
+#endif
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02::fillColor(uint16_t color, uint32_t pixels) const
+{
+    const byte high = color >> 8;
+    const byte low = color & 0xFF;
+    if (high == low)
+    {
+        displayRepeat(high, pixels * 2);
+        return;
+    }
+
+    bool highSent = false;
+    displayStream(pixels * 2, [high, low, &highSent]() {
+        highSent = !highSent;
+        return highSent ? high : low;
+    });
 }
 
 byte Epson_PNL_CE02::readButtons()
 {
-    return synchronize();
+    return scanButtons();
+}
+
+byte Epson_PNL_CE02::scanButtons()
+{
+    const BusOwner owner;
+    const byte output = scanOutput();
+    latch(output);
+    return shiftButtons(output);
+}
+
+// cppcheck-suppress unusedFunction
+byte Epson_PNL_CE02::lastButtons() const
+{
+    return buttons;
+}
+
+void Epson_PNL_CE02::flushExtender()
+{
+    latch(buffer);
+}
+
+byte Epson_PNL_CE02::synchronize()
+{
+    const BusOwner owner;
+#if defined(EPSON_PNL_CE02_STATS)
+    statistics.synchronizeCalls++;
+#endif
+    latch(buffer);
+    return shiftButtons(buffer);
 }
 
 // cppcheck-suppress unusedFunction
 bool Epson_PNL_CE02::isPowerButtonPressed() const
 {
-    return digitalRead(pins->POWER_BUTTON) == LOW;
+    return powerPin.read() == LOW;
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02::setBusHandler(void (*pHandler)())
+{
+    busHandler = pHandler;
+}
+
+void Epson_PNL_CE02::requestBus()
+{
+    if (busDepth > 0 || busSuspend != nullptr)
+    {
+        busRequested = true; // run by the bus owner, or by the asynchronous transfer
+        return;
+    }
+    const BusOwner owner;
+    busRequested = true;
+    serviceBus();
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02::dumpStats(Print &output)
+{
+#if defined(EPSON_PNL_CE02_STATS)
+    output.print(F("synchronize: "));
+    output.println(statistics.synchronizeCalls);
+    output.print(F("latches: "));
+    output.print(statistics.latches);
+    output.print(F(" (unchanged: "));
+    output.print(statistics.idleLatches);
+    output.println(')');
+    output.print(F("SPI bytes: display="));
+    output.print(statistics.displayBytes);
+    output.print(F(" extender="));
+    output.print(statistics.extenderBytes);
+    output.print(F(" buttons="));
+    output.println(statistics.buttonBytes);
+    output.print(F("WR strobes: "));
+    output.println(statistics.writeStrobes);
+    printTiming(output, F("button scan interval"), statistics.scanIntervals);
+    printTiming(output, F("display burst"), statistics.displayBursts);
+#else
+    output.println(F("Stats disabled: build the library with EPSON_PNL_CE02_STATS defined"));
+#endif
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02::resetStats()
+{
+#if defined(EPSON_PNL_CE02_STATS)
+    statistics = Epson_PNL_CE02_Stats();
+#endif
 }
 
+#if defined(EPSON_PNL_CE02_STATS)
+// cppcheck-suppress unusedFunction
+const Epson_PNL_CE02_Stats &Epson_PNL_CE02::stats()
+{
+    return statistics;
+}
+#endif
+
 // PRIVATES
-byte Epson_PNL_CE02::synchronize() const
+void Epson_PNL_CE02::updateExtender()
 {
+    if (updateDepth == 0 && (!latchedValid || buffer != latched))
+    {
+        flushExtender();
+    }
+}
+
+void Epson_PNL_CE02::latch(byte output)
+{
+    const BusOwner owner;
+#if defined(EPSON_PNL_CE02_STATS)
+    statistics.latches++;
+    if (latchedValid && output == latched)
+    {
+        statistics.idleLatches++;
+    }
+#endif
     // STEP 1: Send control information (Power LED, LCD backlight, LCD CS, LCD D/C) through 74HC595
-    digitalWrite(pins->LATCH, LOW); // enables parallel inputs
-    SPIClass::transfer(buffer);
+    latchPin.write(LOW); // enables parallel inputs
+    if (!shiftedValid || shifted != output)
+    {
+        SPIClass::transfer(output);
+        shifted = output;
+        shiftedValid = true;
+#if defined(EPSON_PNL_CE02_STATS)
+        statistics.extenderBytes++;
+#endif
+    }
+    latchPin.write(HIGH); // latch extender, disable parallel inputs and enable serial output
+
+    latched = output;
+    latchedValid = true;
+}
+
+byte Epson_PNL_CE02::shiftButtons(byte output)
+{
     // STEP 2: Receive buttons inputs through 74LV165A
-    digitalWrite(pins->LATCH, HIGH); // disable parallel inputs and enable serial output
+    buttons = shiftIn(output);
+#if defined(EPSON_PNL_CE02_STATS)
+    const uint32_t now = micros();
+    if (statistics.scanned)
+    {
+        statistics.scanIntervals.record(now - statistics.lastScan);
+    }
+    statistics.lastScan = now;
+    statistics.scanned = true;
+#endif
+    return buttons;
+}
 
+byte Epson_PNL_CE02::shiftIn(byte output)
+{
     const byte FULL_MASK = 0b11111111;
-    return FULL_MASK ^ SPIClass::transfer(FULL_MASK); // read buttons (invert cause output is HIGH)
+#if defined(EPSON_PNL_CE02_STATS)
+    statistics.buttonBytes++;
+#endif
+    return FULL_MASK ^ SPIClass::transfer(output); // read buttons (invert cause output is HIGH)
+}
+
+byte Epson_PNL_CE02::scanOutput() const
+{
+    return (updateDepth > 0 && latchedValid) ? latched : buffer; // keep a pending batch unlatched
+}
+
+void Epson_PNL_CE02::displayStrobe() const
+{
+    writePin.strobe();
+}
+
+void Epson_PNL_CE02::serviceBus()
+{
+    void (*handler)() = busHandler;
+    while (busRequested)
+    {
+        busRequested = false;
+        if (handler != nullptr)
+        {
+            handler();
+        }
+    }
+}
+
+void Epson_PNL_CE02::extenderWriteNow(ExtenderPin pin, byte mode)
+{
+    bitWrite(buffer, (byte)pin, mode);
+    byte output = (updateDepth > 0 && latchedValid) ? latched : buffer;
+    bitWrite(output, (byte)pin, mode);
+    if (!latchedValid || output != latched)
+    {
+        latch(output);
+    }
+}
+
+Epson_PNL_CE02::BusOwner::BusOwner()
+{
+    void (*suspend)() = busSuspend;
+    if (busDepth == 0 && suspend != nullptr)
+    {
+        suspend(); // waits for the byte in flight
+    }
+    busDepth = busDepth + 1;
+}
+
+Epson_PNL_CE02::BusOwner::~BusOwner()
+{
+    if (busDepth == 1)
+    {
+        serviceBus(); // still owned, a handler cannot be interrupted by another one
+    }
+    busDepth = busDepth - 1;
+
+    void (*resume)() = busResume;
+    if (busDepth == 0 && resume != nullptr)
+    {
+        resume();
+    }
+}
+
+template <class Next> void Epson_PNL_CE02::displayStream(uint32_t length, Next next) const
+{
+    if (length == 0)
+    {
+        return;
+    }
+    const BusOwner owner;
+    shiftedValid = false;
+#if defined(EPSON_PNL_CE02_STATS)
+    const uint32_t start = micros();
+    statistics.displayBytes += length;
+    statistics.writeStrobes += length;
+#endif
+
+#if defined(SPDR) && defined(SPSR) && defined(SPIF)
+    // Drive the SPI data register directly: the next byte is fetched while the current one is shifted out,
+    // then the 74HC164 holds it during the strobe. A requested bus handler runs between two bytes.
+    SPDR = next();
+    while (--length > 0)
+    {
+        const byte data = next();
+        const bool requested = busRequested;
+        while ((SPSR & _BV(SPIF)) == 0)
+        {
+        }
+        displayStrobe();
+        if (requested)
+        {
+            serviceBus();
+            shiftedValid = false;
+        }
+        SPDR = data;
+    }
+    while ((SPSR & _BV(SPIF)) == 0)
+    {
+    }
+    displayStrobe();
+#else
+    while (length-- > 0)
+    {
+        SPIClass::transfer(next());
+        displayStrobe();
+        if (busRequested)
+        {
+            serviceBus();
+            shiftedValid = false;
+        }
+    }
+#endif
+#if defined(EPSON_PNL_CE02_STATS)
+    statistics.displayBursts.record(micros() - start);
+#endif
 }
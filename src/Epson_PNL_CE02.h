@@ -57,6 +57,12 @@ enum class ButtonMask : byte // NOLINT(readability-identifier-naming): Bug clang
     HOME = 0b00000001,  // 0b01111111
 };
 
+/**
+ * @brief Power button bit in 9-bit buttons sequences, above the 8 ButtonMask bits.
+ * The power button has a dedicated pin (refer to Epson_PNL_CE02_Pinout::POWER_BUTTON).
+ */
+const uint16_t POWER_BUTTON_MASK = 0x100;
+
 /**
  * @brief Shift register pins (VHC595)
  */
@@ -101,6 +107,99 @@ const char *buttonName(ButtonMask mask);
  */
 bool isButtonPressed(byte sequence, ButtonMask mask);
 
+/**
+ * @brief Get the 8-bit extender mask of a pin, to combine pins in Epson_PNL_CE02::extenderWriteMask().
+ *
+ * @param pin shift register pin
+ * @return byte pin mask
+ */
+byte extenderMask(ExtenderPin pin);
+
+/**
+ * @brief Arduino pin resolved once to its port registers.
+ * On AVR, strobing and reading are single port accesses instead of digitalWrite() / digitalRead() lookups.
+ * Other architectures fall back to digitalWrite() / digitalRead().
+ */
+class Epson_PNL_CE02_FastPin // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+  public:
+    /**
+     * @brief Resolve an Arduino pin to its port registers.
+     *
+     * @param pin Arduino pin
+     */
+    explicit Epson_PNL_CE02_FastPin(byte pin)
+#if defined(ARDUINO_ARCH_AVR)
+        : output(portOutputRegister(digitalPinToPort(pin))), input(portInputRegister(digitalPinToPort(pin))),
+          mask(digitalPinToBitMask(pin))
+#else
+        : pin(pin)
+#endif
+    {
+    }
+
+    /**
+     * @brief Set the pin HIGH or LOW. Safe against interrupts writing the same port.
+     *
+     * @param value HIGH / LOW
+     */
+    void write(byte value) const
+    {
+#if defined(ARDUINO_ARCH_AVR)
+        const uint8_t oldSREG = SREG;
+        cli();
+        if (value == LOW)
+        {
+            *output &= ~mask;
+        }
+        else
+        {
+            *output |= mask;
+        }
+        SREG = oldSREG;
+#else
+        digitalWrite(pin, value);
+#endif
+    }
+
+    /**
+     * @brief Pulse the pin LOW then HIGH. The pin must be HIGH.
+     */
+    void strobe() const
+    {
+#if defined(ARDUINO_ARCH_AVR)
+        *input = mask; // writing PINx toggles PORTx, atomic
+        *input = mask;
+#else
+        digitalWrite(pin, LOW);
+        digitalWrite(pin, HIGH);
+#endif
+    }
+
+    /**
+     * @brief Read the pin level.
+     *
+     * @return byte HIGH / LOW
+     */
+    byte read() const
+    {
+#if defined(ARDUINO_ARCH_AVR)
+        return (*input & mask) != 0 ? HIGH : LOW;
+#else
+        return digitalRead(pin);
+#endif
+    }
+
+  private:
+#if defined(ARDUINO_ARCH_AVR)
+    volatile uint8_t *output; // PORTx
+    volatile uint8_t *input;  // PINx
+    uint8_t mask;
+#else
+    byte pin;
+#endif
+};
+
 /**
  * @brief Control panel to Arduino pinout.
  *
@@ -157,6 +256,48 @@ struct Epson_PNL_CE02_Pinout
     const byte LCD_WRITE;
 };
 
+#if defined(EPSON_PNL_CE02_STATS)
+/**
+ * @brief Durations in microseconds: minimum, maximum and histogram.
+ * Bucket `i` counts durations below 4^(i+1) us, the last bucket counts longer ones.
+ */
+struct Epson_PNL_CE02_Timing // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+    static const byte BUCKETS = 8;
+
+    uint32_t count;
+    uint32_t minimum;
+    uint32_t maximum;
+    uint32_t buckets[BUCKETS];
+
+    /**
+     * @brief Add a duration.
+     *
+     * @param duration microseconds
+     */
+    void record(uint32_t duration);
+};
+
+/**
+ * @brief Bus counters gathered when the library is built with EPSON_PNL_CE02_STATS (refer to
+ * Epson_PNL_CE02::dumpStats()).
+ */
+struct Epson_PNL_CE02_Stats // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+    uint32_t synchronizeCalls;           // synchronize() calls
+    uint32_t latches;                    // LATCH cycles
+    uint32_t idleLatches;                // LATCH cycles changing no extender pin
+    uint32_t displayBytes;               // SPI bytes to the display
+    uint32_t extenderBytes;              // SPI bytes to the extender
+    uint32_t buttonBytes;                // SPI bytes reading buttons
+    uint32_t writeStrobes;               // LCD_WRITE strobes
+    Epson_PNL_CE02_Timing scanIntervals; // between two button reads
+    Epson_PNL_CE02_Timing displayBursts; // display streams, from the first byte to the last strobe
+    uint32_t lastScan;                   // micros() of the last button read
+    bool scanned;                        // `lastScan` is valid
+};
+#endif
+
 /**
  * @brief Board class controller.
  *
@@ -197,6 +338,32 @@ class Epson_PNL_CE02 // NOLINT(readability-identifier-naming): Exception to foll
      */
     void extenderWrite(ExtenderPin pin, byte mode);
 
+    /**
+     * @brief Send several extender pins at once, in a single latch cycle.
+     *
+     * @example
+     * ``` c++
+     * // select the display in command mode
+     * cp.extenderWriteMask(extenderMask(ExtenderPin::LCD_CS) | extenderMask(ExtenderPin::LCD_DC), 0);
+     * ```
+     *
+     * @param mask pins to change (refer to extenderMask())
+     * @param value new pins values, bits outside of `mask` are ignored
+     */
+    void extenderWriteMask(byte mask, byte value);
+
+    /**
+     * @brief Start a batch of extender changes. Following extenderWrite() and extenderWriteMask() calls are only
+     * recorded until commitExtender(). Batches can be nested.
+     */
+    void beginExtenderUpdate();
+
+    /**
+     * @brief End a batch of extender changes started by beginExtenderUpdate().
+     * Changes are sent in a single latch cycle, nothing is sent if no pin changed.
+     */
+    void commitExtender();
+
     /**
      * @brief Send parallel data (D0-D7) to the TFT display through the non latched 74HC164.
      *
@@ -204,14 +371,115 @@ class Epson_PNL_CE02 // NOLINT(readability-identifier-naming): Exception to foll
      */
     static void displayWrite(byte data);
 
+    /**
+     * @brief Hardware reset of the TFT display through LCD_RESET.
+     * The display accepts commands 5 ms after this call.
+     */
+    void displayReset() const;
+
+    /**
+     * @brief Stream bytes to the TFT display, each byte is strobed on LCD_WRITE.
+     * Loading the next byte overlaps the strobe of the previous one. LCD_CS and LCD_DC must be set before.
+     *
+     * @param pData parallel data (D0-D7) bytes
+     * @param length number of bytes
+     */
+    void displayWriteBuffer(const byte *pData, size_t length) const;
+
+    /**
+     * @brief Same as displayWriteBuffer() with bytes stored in flash memory (PROGMEM).
+     *
+     * @param pData parallel data (D0-D7) bytes in PROGMEM
+     * @param length number of bytes
+     */
+    // NOLINTNEXTLINE(readability-identifier-naming): Arduino PROGMEM suffix
+    void displayWriteBuffer_P(const byte *pData, size_t length) const;
+
+    /**
+     * @brief Stream 16-bit pixels (RGB565) to the TFT display, high byte first.
+     * Refer to displayWriteBuffer().
+     *
+     * @param pPixels pixels
+     * @param count number of pixels
+     */
+    void displayWritePixels(const uint16_t *pPixels, size_t count) const;
+
+    /**
+     * @brief Same as displayWritePixels() with pixels stored in flash memory (PROGMEM).
+     *
+     * @param pPixels pixels in PROGMEM
+     * @param count number of pixels
+     */
+    // NOLINTNEXTLINE(readability-identifier-naming): Arduino PROGMEM suffix
+    void displayWritePixels_P(const uint16_t *pPixels, size_t count) const;
+
+    /**
+     * @brief Stream palette-indexed pixels stored in flash memory (PROGMEM) to the TFT display, as RGB565.
+     * Indexes are packed most significant bits first. Refer to displayWriteBuffer().
+     *
+     * @param pIndexes palette indexes in PROGMEM, byte aligned
+     * @param bits bits per index: 1, 2, 4 or 8
+     * @param pPalette RGB565 colors in PROGMEM, high byte first
+     * @param count number of pixels
+     */
+    // NOLINTNEXTLINE(readability-identifier-naming): Arduino PROGMEM suffix
+    void displayWriteIndexed_P(const byte *pIndexes, byte bits, const byte *pPalette, size_t count) const;
+
+    /**
+     * @brief Send the same byte `count` times to the TFT display.
+     * The 74HC164 is not latched and holds the last byte shifted in: the byte is sent once, then only LCD_WRITE is
+     * strobed. LCD_CS and LCD_DC must be set before.
+     *
+     * @param value parallel data (D0-D7) byte
+     * @param count number of strobes
+     */
+    void displayRepeat(byte value, uint32_t count) const;
+
+    /**
+     * @brief Send the same 16-bit pixel (RGB565) `pixels` times to the TFT display.
+     * Colors with equal high and low bytes (black, white...) only strobe LCD_WRITE, refer to displayRepeat().
+     *
+     * @param color RGB565 color
+     * @param pixels number of pixels
+     */
+    void fillColor(uint16_t color, uint32_t pixels) const;
+
     /**
      * @brief Read current pressed buttons in 8-bit sequence (`0`: no pressed, `1`: pressed).
-     * Use ButtonMask to determine witch button is pressed.
+     * Use ButtonMask to determine witch button is pressed. Same as scanButtons().
      *
      * @return byte Current pressed buttons in 8-bit sequence
      */
     byte readButtons();
 
+    /**
+     * @brief Read current pressed buttons without writing the extender.
+     * Costs one SPI byte, plus one if the display was written since the last extender transaction.
+     * Pending changes of a batch (refer to beginExtenderUpdate()) are not sent.
+     *
+     * @return byte Current pressed buttons in 8-bit sequence
+     */
+    byte scanButtons();
+
+    /**
+     * @brief Last buttons read by scanButtons() or synchronize(), without any bus access.
+     *
+     * @return byte Last pressed buttons in 8-bit sequence
+     */
+    byte lastButtons() const;
+
+    /**
+     * @brief Write the extender without reading buttons (one SPI byte).
+     */
+    void flushExtender();
+
+    /**
+     * @brief Write the extender and read buttons in the same transaction.
+     *
+     * @return byte Current pressed buttons in 8-bit sequence
+     */
+    byte synchronize();
+
     /**
      * @brief Determine if the power button is pressed or not. The power button has a dedicated pin.
      * Require a pull-up resistor (10K).
@@ -221,17 +489,142 @@ class Epson_PNL_CE02 // NOLINT(readability-identifier-naming): Exception to foll
      */
     bool isPowerButtonPressed() const;
 
+    /**
+     * @brief Register the function run by requestBus(), it may use any bus function of the library.
+     *
+     * @param pHandler bus handler, nullptr to remove it
+     */
+    static void setBusHandler(void (*pHandler)());
+
+    /**
+     * @brief Run the bus handler as soon as the shared bus (SPI, LATCH, LCD_WRITE) is free. Safe from interrupts.
+     * The handler runs immediately when the bus is idle. Otherwise the current bus transaction runs it when it ends,
+     * or between two bytes of a long display stream or of an asynchronous transfer (refer to
+     * Epson_PNL_CE02_DisplayQueue). The display data are sent again after the handler.
+     */
+    static void requestBus();
+
+    /**
+     * @brief Print the bus counters and timings gathered since the last resetStats().
+     * Counters are only gathered when the library is built with EPSON_PNL_CE02_STATS defined, otherwise the bus
+     * functions are left unchanged and a notice is printed.
+     *
+     * @param output e.g. Serial
+     */
+    static void dumpStats(Print &output);
+
+    /**
+     * @brief Reset the bus counters and timings.
+     */
+    static void resetStats();
+
+#if defined(EPSON_PNL_CE02_STATS)
+    /**
+     * @brief Bus counters and timings gathered since the last resetStats().
+     */
+    static const Epson_PNL_CE02_Stats &stats();
+#endif
+
   private:
     Epson_PNL_CE02_Pinout *pins;
-    byte buffer{0b0}; // SERIAL IN 74HC595 - Control panel extender (refer to ExtenderPin)
+    Epson_PNL_CE02_FastPin latchPin;
+    Epson_PNL_CE02_FastPin writePin;
+    Epson_PNL_CE02_FastPin powerPin;
+    byte buffer{0b0};         // SERIAL IN 74HC595 - Control panel extender (refer to ExtenderPin)
+    byte latched{0b0};        // Last buffer latched in the 74HC595
+    bool latchedValid{false}; // `latched` is unknown until the first synchronization
+    byte updateDepth{0};      // Nested beginExtenderUpdate() calls
+    byte buttons{0b0};        // Last buttons read (refer to ButtonMask)
+
+    static byte shifted;      // Last byte shifted on the bus, held by the 74HC595 shift register
+    static bool shiftedValid; // `shifted` is unknown after display writes
+
+    static volatile byte busDepth;        // Nested bus transactions in progress
+    static volatile bool busRequested;    // requestBus() called while the bus was owned
+    static void (*volatile busHandler)(); // refer to setBusHandler()
+    static void (*volatile busSuspend)(); // Pause the asynchronous transfer running, when a transaction starts
+    static void (*volatile busResume)();  // Resume the asynchronous transfer, when the transaction ends
+
+#if defined(EPSON_PNL_CE02_STATS)
+    static Epson_PNL_CE02_Stats statistics; // refer to stats()
+#endif
+
+    friend class Epson_PNL_CE02_DisplayQueue;
+    friend class Epson_PNL_CE02_Group;
+    friend class Epson_PNL_CE02_IdleManager;
+
+    /**
+     * @brief Own the bus for the lifetime of the object, run a requested bus handler on release.
+     */
+    class BusOwner
+    {
+      public:
+        BusOwner();
+        ~BusOwner();
+        BusOwner(const BusOwner &) = delete;
+        BusOwner &operator=(const BusOwner &) = delete;
+    };
+
+    /**
+     * @brief Run the bus handler if requested, the bus must be owned.
+     */
+    static void serviceBus();
 
     /**
-     * @brief Read and write to shift registers that control buttons, power led and display.
-     * Called each time a refresh is needed.
+     * @brief Latch an extender pin immediately, even during a batch (refer to beginExtenderUpdate()).
+     * Other pending changes of the batch are kept pending.
      *
+     * @param pin shift register pin
+     * @param mode HIGH / LOW
+     */
+    void extenderWriteNow(ExtenderPin pin, byte mode);
+
+    /**
+     * @brief Synchronize the extender if `buffer` changed since the last latch and no batch is in progress.
+     */
+    void updateExtender();
+
+    /**
+     * @brief Latch a value in the extender. The LATCH rising edge also loads buttons in the 74LV165A.
+     * The value is shifted only if the 74HC595 shift register does not already hold it.
+     *
+     * @param output extender value
+     */
+    void latch(byte output);
+
+    /**
+     * @brief Read buttons loaded by latch(), `output` is shifted again to keep it in the 74HC595 shift register.
+     *
+     * @param output extender value
      * @return byte Current pressed buttons in 8-bit sequence
      */
-    byte synchronize() const;
+    byte shiftButtons(byte output);
+
+    /**
+     * @brief Shift a byte out of the 74LV165A chain, `output` is shifted in the 74HC595 shift registers.
+     *
+     * @param output extender value
+     * @return byte Pressed buttons of the byte read
+     */
+    static byte shiftIn(byte output);
+
+    /**
+     * @brief Extender value to latch when reading buttons: a pending batch is kept unlatched.
+     */
+    byte scanOutput() const;
+
+    /**
+     * @brief Strobe LCD_WRITE, the display reads D0-D7 on the rising edge.
+     */
+    void displayStrobe() const;
+
+    /**
+     * @brief Shift bytes to the display and strobe each of them.
+     *
+     * @param length number of bytes
+     * @param next functor returning the next byte to send
+     */
+    template <class Next> void displayStream(uint32_t length, Next next) const;
 };
 
 #endif // Epson_PNL_CE02_H
@@ -0,0 +1,179 @@
+/**
+ * @file Epson_PNL_CE02_ButtonScanner.cpp
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Interrupt-driven buttons scanner of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#include "Epson_PNL_CE02_ButtonScanner.h"
+#include <Arduino.h>
+
+namespace
+{
+Epson_PNL_CE02_ButtonScanner *pRunning = nullptr; // scanner started by begin()
+bool timerAttached = false;                         // EPSON_PNL_CE02_BUTTON_SCANNER_ISR() defined in the sketch
+} // namespace
+
+// CTOR
+Epson_PNL_CE02_ButtonScanner::Epson_PNL_CE02_ButtonScanner(Epson_PNL_CE02 *pControlPanel)
+    : controlPanel(pControlPanel)
+{
+}
+
+// PUBLICS
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_ButtonScanner::begin(byte periodMs)
+{
+    period = periodMs > 0 ? periodMs : 1;
+    ticks = 0;
+    pRunning = this;
+    Epson_PNL_CE02::setBusHandler(scanHandler);
+
+#if defined(ARDUINO_ARCH_AVR) && defined(TIMER0_COMPB_vect)
+    // Timer0 overflows every 1.024 ms for millis(), compare B fires once per overflow whatever OCR0B
+    if (timerAttached)
+    {
+        if ((TCCR0A & (_BV(COM0B1) | _BV(COM0B0))) == 0)
+        {
+            const byte COMPARE_MIDDLE = 0x80; // away from the millis() interrupt
+            OCR0B = COMPARE_MIDDLE;
+        }
+        // else OCR0B is the PWM duty of OC0B (analogWrite()), kept
+        TIMSK0 |= _BV(OCIE0B);
+    }
+#endif
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_ButtonScanner::end()
+{
+#if defined(ARDUINO_ARCH_AVR) && defined(TIMER0_COMPB_vect)
+    TIMSK0 &= ~_BV(OCIE0B);
+#endif
+    Epson_PNL_CE02::setBusHandler(nullptr);
+    pRunning = nullptr;
+}
+
+void Epson_PNL_CE02_ButtonScanner::tick()
+{
+    ticks = ticks + 1;
+    if (ticks >= period)
+    {
+        ticks = 0;
+        Epson_PNL_CE02::requestBus(); // now, or by the display stream owning the bus
+    }
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_ButtonScanner::timerInterrupt()
+{
+    if (pRunning != nullptr)
+    {
+        pRunning->tick();
+    }
+}
+
+// cppcheck-suppress unusedFunction
+bool Epson_PNL_CE02_ButtonScanner::attachTimerInterrupt()
+{
+    timerAttached = true;
+    return true;
+}
+
+bool Epson_PNL_CE02_ButtonScanner::available() const
+{
+    return head != tail;
+}
+
+// cppcheck-suppress unusedFunction
+bool Epson_PNL_CE02_ButtonScanner::read(ButtonEvent &event)
+{
+    const byte index = tail;
+    if (index == head)
+    {
+        return false;
+    }
+    event.time = events[index].time;
+    event.button = events[index].button;
+    event.pressed = events[index].pressed;
+    tail = (index + 1) & (QUEUE_SIZE - 1); // release the slot once copied
+    return true;
+}
+
+// cppcheck-suppress unusedFunction
+uint16_t Epson_PNL_CE02_ButtonScanner::pressedButtons() const
+{
+#if defined(ARDUINO_ARCH_AVR)
+    // Two bytes read at once, the interrupt state is restored: safe from a bus handler or an interrupt
+    const uint8_t oldSREG = SREG;
+    cli();
+    const uint16_t pressed = state;
+    SREG = oldSREG;
+    return pressed;
+#else
+    return state; // single access on 16 and 32-bit MCUs
+#endif
+}
+
+// cppcheck-suppress unusedFunction
+byte Epson_PNL_CE02_ButtonScanner::droppedEvents() const
+{
+    return dropped;
+}
+
+// PRIVATES
+void Epson_PNL_CE02_ButtonScanner::scanHandler()
+{
+    if (pRunning != nullptr)
+    {
+        pRunning->scan();
+    }
+}
+
+void Epson_PNL_CE02_ButtonScanner::scan()
+{
+    const uint16_t previous = state;
+    uint16_t current = controlPanel->scanButtons();
+    if (controlPanel->isPowerButtonPressed())
+    {
+        current |= POWER_BUTTON_MASK;
+    }
+    state = current;
+
+    uint16_t changes = previous ^ current;
+    if (changes == 0)
+    {
+        return;
+    }
+
+    const unsigned long now = millis();
+    for (uint16_t button = 1; changes != 0; button <<= 1)
+    {
+        if ((changes & button) != 0)
+        {
+            push(button, (current & button) != 0, now);
+            changes &= ~button;
+        }
+    }
+}
+
+void Epson_PNL_CE02_ButtonScanner::push(uint16_t button, bool pressed, unsigned long time)
+{
+    const byte index = head;
+    const byte next = (index + 1) & (QUEUE_SIZE - 1);
+    if (next == tail)
+    {
+        if (dropped < 0xFF)
+        {
+            dropped = dropped + 1;
+        }
+        return;
+    }
+    events[index].time = time;
+    events[index].button = button;
+    events[index].pressed = pressed;
+    head = next; // publish once written
+}
@@ -0,0 +1,181 @@
+/**
+ * @file Epson_PNL_CE02_ButtonScanner.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Interrupt-driven buttons scanner of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * Buttons are scanned at a fixed rate from a timer interrupt, independently of the time spent by loop() drawing.
+ * A scan never breaks a bus transaction: while the display owns the bus, the scan is run by the display stream
+ * between two bytes (refer to Epson_PNL_CE02::requestBus()).
+ * Press and release events are queued in a lock-free single-producer / single-consumer ring buffer.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_BUTTON_SCANNER_H
+#define EPSON_PNL_CE02_BUTTON_SCANNER_H
+
+#include <Arduino.h>
+#include <Epson_PNL_CE02.h>
+
+#ifndef EPSON_PNL_CE02_EVENT_QUEUE_SIZE
+#define EPSON_PNL_CE02_EVENT_QUEUE_SIZE 16 // power of two
+#endif
+
+/**
+ * @brief Button press or release.
+ */
+struct ButtonEvent
+{
+    /**
+     * @brief millis() at the scan detecting the change.
+     */
+    unsigned long time;
+
+    /**
+     * @brief ButtonMask value, or POWER_BUTTON_MASK.
+     */
+    uint16_t button;
+
+    /**
+     * @brief true when pressed, false when released.
+     */
+    bool pressed;
+};
+
+/**
+ * @brief Buttons scanner, pushing press and release events of the 8 buttons and the power button.
+ *
+ * On AVR, begin() scans from the Timer0 compare B interrupt, sharing the millis() timer (~1 kHz), once the sketch
+ * defines it with EPSON_PNL_CE02_BUTTON_SCANNER_ISR(). Without it, the vector is left to other code.
+ * OCR0B also sets the PWM duty of OC0B (pin 4 on MEGA 2560, pin 5 on UNO): begin() keeps it when analogWrite() already
+ * drives this pin, otherwise it sets OCR0B to 0x80, away from the millis() interrupt. analogWrite() on this pin
+ * only moves the scans within the timer period, they still run once per overflow.
+ * On other architectures, or without the interrupt, call tick() from a timer interrupt or from loop().
+ *
+ * @example
+ * ``` c++
+ * Epson_PNL_CE02_ButtonScanner scanner(&controlPanel);
+ * EPSON_PNL_CE02_BUTTON_SCANNER_ISR(); // once in the sketch
+ *
+ * scanner.begin(10); // every 10 ms
+ *
+ * ButtonEvent event;
+ * while (scanner.read(event)) {
+ *     Serial.println(event.pressed ? "pressed" : "released");
+ * }
+ * ```
+ */
+class Epson_PNL_CE02_ButtonScanner // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    static const byte QUEUE_SIZE = EPSON_PNL_CE02_EVENT_QUEUE_SIZE;
+
+    /**
+     * @brief Construct a new Epson_PNL_CE02_ButtonScanner object
+     *
+     * @param pControlPanel Reference to the Epson_PNL_CE02 reading buttons.
+     */
+    explicit Epson_PNL_CE02_ButtonScanner(Epson_PNL_CE02 *pControlPanel);
+
+    /**
+     * @brief Start scanning. A single scanner can run at a time.
+     * Epson_PNL_CE02::begin() must be called before.
+     *
+     * @param periodMs scan period in milliseconds
+     */
+    void begin(byte periodMs = 10);
+
+    /**
+     * @brief Stop scanning.
+     */
+    void end();
+
+    /**
+     * @brief Count a timer tick, scans every `periodMs` ticks. Called by the timer interrupt on AVR.
+     */
+    void tick();
+
+    /**
+     * @brief Timer0 compare B interrupt, defined in the sketch by EPSON_PNL_CE02_BUTTON_SCANNER_ISR().
+     */
+    static void timerInterrupt();
+
+    /**
+     * @brief Let begin() enable the Timer0 compare B interrupt. Called by EPSON_PNL_CE02_BUTTON_SCANNER_ISR().
+     *
+     * @return true
+     */
+    static bool attachTimerInterrupt();
+
+    /**
+     * @brief Determine if events are waiting.
+     *
+     * @return true
+     * @return false
+     */
+    bool available() const;
+
+    /**
+     * @brief Get the oldest event, never blocks.
+     *
+     * @param event receives the event
+     * @return true if an event was read
+     */
+    bool read(ButtonEvent &event);
+
+    /**
+     * @brief Buttons pressed at the last scan, in 9-bit sequence (refer to ButtonMask and POWER_BUTTON_MASK).
+     *
+     * @return uint16_t pressed buttons
+     */
+    uint16_t pressedButtons() const;
+
+    /**
+     * @brief Number of events lost because the queue was full, saturated at 255.
+     *
+     * @return byte lost events
+     */
+    byte droppedEvents() const;
+
+  private:
+    static_assert((QUEUE_SIZE & (QUEUE_SIZE - 1)) == 0, "EPSON_PNL_CE02_EVENT_QUEUE_SIZE must be a power of two");
+
+    Epson_PNL_CE02 *controlPanel;
+    byte period{1};
+    volatile byte ticks{0};
+    volatile uint16_t state{0};
+    volatile byte dropped{0};
+
+    // Ring buffer: `head` is only written by scan(), `tail` only by read()
+    volatile ButtonEvent events[QUEUE_SIZE];
+    volatile byte head{0};
+    volatile byte tail{0};
+
+    /**
+     * @brief Bus handler, scans buttons and pushes changes.
+     */
+    static void scanHandler();
+
+    void scan();
+    void push(uint16_t button, bool pressed, unsigned long time);
+};
+
+/**
+ * @brief Define the Timer0 compare B interrupt of the scanner, once in the sketch (AVR).
+ * The library does not define it: sketches not using the scanner keep the vector for other code.
+ */
+#if defined(ARDUINO_ARCH_AVR) && defined(TIMER0_COMPB_vect)
+#define EPSON_PNL_CE02_BUTTON_SCANNER_ISR()                                                                            \
+    ISR(TIMER0_COMPB_vect)                                                                                             \
+    {                                                                                                                  \
+        Epson_PNL_CE02_ButtonScanner::timerInterrupt();                                                                \
+    }                                                                                                                  \
+    static const bool EPSON_PNL_CE02_BUTTON_SCANNER_ATTACHED = Epson_PNL_CE02_ButtonScanner::attachTimerInterrupt()
+#else
+#define EPSON_PNL_CE02_BUTTON_SCANNER_ISR() static_assert(true, "call tick() from a timer interrupt")
+#endif
+
+#endif // EPSON_PNL_CE02_BUTTON_SCANNER_H
@@ -0,0 +1,190 @@
+/**
+ * @file Epson_PNL_CE02_Console.cpp
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Scrolling text console of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#include "Epson_PNL_CE02_Console.h"
+#include <Arduino.h>
+
+namespace
+{
+const int16_t WIDTH = Epson_PNL_CE02_Display::WIDTH;
+const int16_t HEIGHT = Epson_PNL_CE02_Display::HEIGHT;
+
+/**
+ * @brief Determine if a character ends a run drawn at once.
+ */
+bool isControl(uint8_t value)
+{
+    return value == '\n' || value == '\r';
+}
+} // namespace
+
+// CTOR
+Epson_PNL_CE02_Console::Epson_PNL_CE02_Console(Epson_PNL_CE02_Display *pDisplay, const Epson_PNL_CE02_Font *pFont)
+    : display(pDisplay), text(pDisplay, pFont)
+{
+}
+
+// PUBLICS
+void Epson_PNL_CE02_Console::begin(byte headerHeight, byte footerHeight)
+{
+    const int16_t area = HEIGHT - headerHeight - footerHeight;
+    top = headerHeight;
+    lineHeight = text.lineHeight();
+    lineCount = area > 0 ? area / lineHeight : 0;
+    columnCount = WIDTH / text.charWidth();
+    if (lineCount == 0)
+    {
+        return;
+    }
+
+    // Fixed bands around the whole lines
+    const uint16_t scrolled = lineCount * lineHeight;
+    const uint16_t bottom = HEIGHT - top - scrolled;
+    const byte params[] = {
+        static_cast<byte>(top >> 8),      static_cast<byte>(top),      // TFA
+        static_cast<byte>(scrolled >> 8), static_cast<byte>(scrolled), // VSA
+        static_cast<byte>(bottom >> 8),   static_cast<byte>(bottom),   // BFA
+    };
+    display->setRotation(0);
+    display->writeCommand(DisplayCommand::VSCRDEF, params, sizeof(params));
+    display->fillRect(0, top + scrolled, WIDTH, bottom - footerHeight, background);
+    clear();
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Console::end()
+{
+    const byte params[] = {0, 0, 0, HEIGHT, 0, 0};
+    display->writeCommand(DisplayCommand::VSCRDEF, params, sizeof(params));
+    setScrollStart(0);
+    lineCount = 0;
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Console::setColors(uint16_t foreground, uint16_t background)
+{
+    this->background = background;
+    text.setColors(foreground, background);
+}
+
+void Epson_PNL_CE02_Console::clear()
+{
+    if (lineCount == 0)
+    {
+        return;
+    }
+    display->fillRect(0, top, WIDTH, lineCount * lineHeight, background);
+    firstLine = 0;
+    setScrollStart(top);
+    cursorLine = 0;
+    cursorColumn = 0;
+    newLinePending = false;
+    wrapped = false;
+}
+
+// cppcheck-suppress unusedFunction
+byte Epson_PNL_CE02_Console::columns() const
+{
+    return columnCount;
+}
+
+// cppcheck-suppress unusedFunction
+byte Epson_PNL_CE02_Console::rows() const
+{
+    return lineCount;
+}
+
+size_t Epson_PNL_CE02_Console::write(uint8_t value)
+{
+    return write(&value, 1);
+}
+
+size_t Epson_PNL_CE02_Console::write(const uint8_t *pBuffer, size_t size)
+{
+    if (lineCount == 0)
+    {
+        return 0;
+    }
+
+    size_t position = 0;
+    while (position < size)
+    {
+        const uint8_t value = pBuffer[position];
+        if (value == '\n')
+        {
+            if (newLinePending && !wrapped)
+            {
+                newLine(); // blank line
+            }
+            newLinePending = true;
+            wrapped = false;
+            position++;
+            continue;
+        }
+        if (value == '\r')
+        {
+            cursorColumn = 0;
+            position++;
+            continue;
+        }
+
+        if (newLinePending)
+        {
+            newLine();
+        }
+
+        // Run of characters up to a control character or the end of the line
+        byte count = 0;
+        while (position + count < size && cursorColumn + count < columnCount && !isControl(pBuffer[position + count]))
+        {
+            count++;
+        }
+        text.drawChars(cursorColumn * text.charWidth(), lineRow(cursorLine),
+                       reinterpret_cast<const char *>(pBuffer + position), count);
+        position += count;
+        cursorColumn += count;
+        if (cursorColumn == columnCount)
+        {
+            newLinePending = true; // wrap
+            wrapped = true;
+        }
+    }
+    return size;
+}
+
+// PRIVATES
+void Epson_PNL_CE02_Console::newLine()
+{
+    newLinePending = false;
+    wrapped = false;
+    cursorColumn = 0;
+    if (cursorLine + 1 < lineCount)
+    {
+        cursorLine++; // lines below the cursor are still blank
+        return;
+    }
+
+    // The top line becomes the bottom line
+    display->fillRect(0, lineRow(0), WIDTH, lineHeight, background);
+    firstLine = firstLine + 1 < lineCount ? firstLine + 1 : 0;
+    setScrollStart(lineRow(0));
+}
+
+int16_t Epson_PNL_CE02_Console::lineRow(byte line) const
+{
+    const byte index = (firstLine + line) % lineCount;
+    return top + index * lineHeight;
+}
+
+void Epson_PNL_CE02_Console::setScrollStart(int16_t row)
+{
+    const byte params[] = {static_cast<byte>(row >> 8), static_cast<byte>(row)};
+    display->writeCommand(DisplayCommand::VSCRSADD, params, sizeof(params));
+}
@@ -0,0 +1,133 @@
+/**
+ * @file Epson_PNL_CE02_Console.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Scrolling text console of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * Lines are scrolled by the ILI9163C itself: the scroll area (VSCRDEF) is a circular buffer of text lines in the
+ * frame memory, and the start address (VSCRSADD) selects the line shown at the top. A new line at the bottom only
+ * clears the oldest line, moves the start address, then draws its text: nothing else is sent again.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_CONSOLE_H
+#define EPSON_PNL_CE02_CONSOLE_H
+
+#include <Arduino.h>
+#include <Epson_PNL_CE02_Display.h>
+#include <Epson_PNL_CE02_Font.h>
+#include <Epson_PNL_CE02_Text.h>
+
+/**
+ * @brief Print-compatible text console, scrolled by the display, between optional fixed header and footer bands.
+ *
+ * Header and footer bands do not scroll: draw them with Epson_PNL_CE02_Display or Epson_PNL_CE02_Text, at rows
+ * `0` to `headerHeight - 1` and `HEIGHT - footerHeight` to `HEIGHT - 1`.
+ * The console requires the rotation 0: vertical scrolling follows the rows of the frame memory.
+ *
+ * @example
+ * ``` c++
+ * Epson_PNL_CE02_Console console(&display);
+ * console.begin(10); // 10 rows of header
+ * text.drawText(0, 1, "Log");
+ * console.println(F("Booting..."));
+ * ```
+ */
+class Epson_PNL_CE02_Console : public Print // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    /**
+     * @brief Construct a new Epson_PNL_CE02_Console object, white on black.
+     *
+     * @param pDisplay Reference to the display receiving the console.
+     * @param pFont font (default: EPSON_PNL_CE02_FONT_6X8)
+     */
+    explicit Epson_PNL_CE02_Console(Epson_PNL_CE02_Display *pDisplay,
+                                    const Epson_PNL_CE02_Font *pFont = &EPSON_PNL_CE02_FONT_6X8);
+
+    /**
+     * @brief Define the scroll area between the header and footer bands, then clear it.
+     * The scroll area is rounded down to whole lines, remaining rows are cleared and added to the footer band.
+     *
+     * @param headerHeight rows of the fixed band at the top
+     * @param footerHeight rows of the fixed band at the bottom
+     */
+    void begin(byte headerHeight = 0, byte footerHeight = 0);
+
+    /**
+     * @brief Scroll the whole screen back to its normal position, the console stays on screen.
+     */
+    void end();
+
+    /**
+     * @brief Set the colors of the next characters, the background also clears new lines.
+     *
+     * @param foreground RGB565 color of the glyphs
+     * @param background RGB565 color of the rest of the lines
+     */
+    void setColors(uint16_t foreground, uint16_t background);
+
+    /**
+     * @brief Clear the scroll area, the cursor returns to the top.
+     */
+    void clear();
+
+    /**
+     * @brief Characters per line.
+     */
+    byte columns() const;
+
+    /**
+     * @brief Lines of the scroll area.
+     */
+    byte rows() const;
+
+    /**
+     * @brief Write a character. '\n' starts a new line, '\r' returns to the start of the line.
+     * A new line is started by the next character: the last line printed stays at the bottom. A full line wraps, the
+     * first '\n' after it ends the same line.
+     *
+     * @return size_t 1
+     */
+    size_t write(uint8_t value) override;
+
+    /**
+     * @brief Write characters, each run of characters of a line is drawn through a single window.
+     *
+     * @return size_t size
+     */
+    size_t write(const uint8_t *pBuffer, size_t size) override;
+
+    using Print::write;
+
+  private:
+    Epson_PNL_CE02_Display *display;
+    Epson_PNL_CE02_Text text;
+    uint16_t background = 0x0000;
+    int16_t top = 0;             // first row of the scroll area
+    int16_t lineHeight = 0;      // rows of a line
+    byte lineCount = 0;          // lines of the scroll area
+    byte columnCount = 0;        // characters per line
+    byte firstLine = 0;          // line of the frame memory shown at the top
+    byte cursorLine = 0;         // line on screen
+    byte cursorColumn = 0;       // character of the line
+    bool newLinePending = false; // the next character starts a new line
+    bool wrapped = false;        // newLinePending set by a full line, the next '\n' ends this line
+
+    /**
+     * @brief Move the cursor to the start of the next line, scrolling when it is on the last line.
+     */
+    void newLine();
+
+    /**
+     * @brief First row of a line of the screen, in the frame memory.
+     */
+    int16_t lineRow(byte line) const;
+
+    void setScrollStart(int16_t row);
+};
+
+#endif // EPSON_PNL_CE02_CONSOLE_H
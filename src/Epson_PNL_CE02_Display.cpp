@@ -0,0 +1,606 @@
+/**
+ * @file Epson_PNL_CE02_Display.cpp
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief ILI9163C display driver of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#include "Epson_PNL_CE02_Display.h"
+#include <Arduino.h>
+
+namespace
+{
+const byte MADCTL_MY = 0x80;  // Row address order
+const byte MADCTL_MX = 0x40;  // Column address order
+const byte MADCTL_MV = 0x20;  // Row / column exchange
+const byte MADCTL_BGR = 0x08; // Panel color order
+const byte CASET_BYTES = 5; // command + 4 parameters
+const byte RASET_BYTES = 5; // command + 4 parameters
+const byte RAMWR_BYTES = 1;
+const byte PACKED_CHUNK = 48; // RGB444 bytes packed at once, 32 pixels
+const byte COMMAND_DELAY = 0x80; // writeCommands_P(): a delay follows the parameters
+
+// Minimum ILI9163C delays
+const unsigned long RESET_DELAY_MS = 5;       // reset to the first command
+const unsigned long SLEEP_OUT_WAIT_US = 120000; // reset to SLPOUT
+
+// Sent 5 ms after the reset, while the display sleeps: the frame memory is written in sleep mode
+// Panel tuning of the ILI9163C 128x128 modules, as in MCUFRIEND_kbv (0x9163) and TFT_ILI9163C
+const byte INIT_COMMANDS[] PROGMEM = {
+    static_cast<byte>(DisplayCommand::FRMCTR1), 2, 0x08, 0x02, // oscillator division and line period
+    static_cast<byte>(DisplayCommand::INVCTR), 1, 0x07,        // frame inversion in every mode
+    static_cast<byte>(DisplayCommand::PWCTR1), 2, 0x0A, 0x02,  // GVDD and VCI1 levels
+    static_cast<byte>(DisplayCommand::PWCTR2), 1, 0x02,        // VGH and VGL step-up factor
+    static_cast<byte>(DisplayCommand::VMCTR1), 2, 0x50, 0x5B,  // VCOMH and VCOML levels
+    static_cast<byte>(DisplayCommand::VMOFCTR), 1, 0x40,       // VCOM offset of the module
+    static_cast<byte>(DisplayCommand::GAMSET), 1, 0x04,        // curve 3, corrected below
+    static_cast<byte>(DisplayCommand::GAMRSEL), 1, 0x01,       // gamma adjustment enabled
+    static_cast<byte>(DisplayCommand::PGAMCTRL), 15,
+    0x3F, 0x25, 0x1C, 0x1E, 0x20, 0x12, 0x2A, 0x90, 0x24, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00,
+    static_cast<byte>(DisplayCommand::NGAMCTRL), 15,
+    0x20, 0x20, 0x20, 0x20, 0x05, 0x00, 0x15, 0xA7, 0x3D, 0x18, 0x25, 0x2A, 0x2B, 0x2B, 0x3A,
+    static_cast<byte>(DisplayCommand::COLMOD), 1, static_cast<byte>(ColorMode::RGB565),
+    static_cast<byte>(DisplayCommand::MADCTL), 1, MADCTL_BGR, // rotation 0
+    static_cast<byte>(DisplayCommand::NORON), 0,
+    static_cast<byte>(DisplayCommand::NOP),
+};
+
+// Sent 120 ms after the reset, the display is turned on by begin() with the backlight
+const byte WAKE_COMMANDS[] PROGMEM = {
+    static_cast<byte>(DisplayCommand::SLPOUT), COMMAND_DELAY | 0, 5, // supplies and oscillator settle
+    static_cast<byte>(DisplayCommand::NOP),
+};
+
+// 4x4 Bayer matrix, thresholds 0 to 15
+const byte BAYER[4][4] = {
+    {0, 8, 2, 10},
+    {12, 4, 14, 6},
+    {3, 11, 1, 9},
+    {15, 7, 13, 5},
+};
+
+/**
+ * @brief Bytes of packed RGB444 pixels, an odd last pixel takes 2 bytes.
+ */
+uint32_t packedLength(uint32_t count)
+{
+    return count / 2 * 3 + (count & 1) * 2;
+}
+} // namespace
+
+// CTOR
+Epson_PNL_CE02_Display::Epson_PNL_CE02_Display(Epson_PNL_CE02 *pControlPanel) : controlPanel(pControlPanel)
+{
+}
+
+// PUBLICS
+void Epson_PNL_CE02_Display::begin(const byte *pSplash)
+{
+    // Display selected for good: the VHC164 data are only read on LCD_WRITE strobes
+    controlPanel->beginExtenderUpdate();
+    controlPanel->extenderWrite(ExtenderPin::LCD_CS, LOW);
+    controlPanel->extenderWrite(ExtenderPin::LCD_DC, LOW); // first command
+    controlPanel->commitExtender();
+
+    controlPanel->displayReset();
+    const unsigned long reset = micros();
+    invalidate();
+    savedBytes = 0;
+    delay(RESET_DELAY_MS);
+
+    writeCommands_P(INIT_COMMANDS);
+    currentMode = ColorMode::RGB565;
+    dithering = false;
+
+    // The frame memory is drawn during the wait for SLPOUT
+    if (pSplash == nullptr || !drawSplash(pSplash))
+    {
+        fillRect(0, 0, WIDTH, HEIGHT, 0x0000);
+    }
+
+    const unsigned long elapsed = micros() - reset;
+    if (elapsed < SLEEP_OUT_WAIT_US)
+    {
+        delay((SLEEP_OUT_WAIT_US - elapsed + 999) / 1000);
+    }
+    writeCommands_P(WAKE_COMMANDS);
+
+    // Lit with the display on
+    controlPanel->beginExtenderUpdate();
+    controlPanel->extenderWrite(ExtenderPin::LCD_BACKLIGHT, HIGH);
+    controlPanel->extenderWrite(ExtenderPin::LCD_DC, LOW);
+    controlPanel->commitExtender();
+    writeCommand(DisplayCommand::DISPON);
+    firstPixel = micros();
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Display::writeCommands_P(const byte *pCommands)
+{
+    byte command = pgm_read_byte(pCommands++);
+    while (command != static_cast<byte>(DisplayCommand::NOP))
+    {
+        const byte header = pgm_read_byte(pCommands++);
+        const byte count = header & ~COMMAND_DELAY;
+        writeCommandCode(static_cast<DisplayCommand>(command));
+        if (count > 0)
+        {
+            controlPanel->extenderWrite(ExtenderPin::LCD_DC, HIGH); // data, streamed from PROGMEM
+            controlPanel->displayWriteBuffer_P(pCommands, count);
+            pCommands += count;
+        }
+        if ((header & COMMAND_DELAY) != 0)
+        {
+            delay(pgm_read_byte(pCommands++));
+        }
+        command = pgm_read_byte(pCommands++);
+    }
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long Epson_PNL_CE02_Display::firstPixelMicros() const
+{
+    return firstPixel;
+}
+
+void Epson_PNL_CE02_Display::writeCommand(DisplayCommand command, const byte *pParams, byte count)
+{
+    writeCommandCode(command);
+    if (count > 0)
+    {
+        controlPanel->extenderWrite(ExtenderPin::LCD_DC, HIGH); // data
+        controlPanel->displayWriteBuffer(pParams, count);
+    }
+}
+
+void Epson_PNL_CE02_Display::setWindow(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+    const byte WINDOW_BYTES = CASET_BYTES + RASET_BYTES + RAMWR_BYTES;
+    if (continuesBurst(x0, y0, x1, y1))
+    {
+        savedBytes += WINDOW_BYTES;
+        return;
+    }
+
+    byte sent = RAMWR_BYTES;
+    if (!columnsValid || x0 != windowX0 || x1 != windowX1)
+    {
+        const byte columns[] = {highByte(x0), lowByte(x0), highByte(x1), lowByte(x1)};
+        writeCommand(DisplayCommand::CASET, columns, sizeof(columns));
+        windowX0 = x0;
+        windowX1 = x1;
+        columnsValid = true;
+        sent += CASET_BYTES;
+    }
+    if (!rowsValid || y0 != windowY0 || y1 != windowY1)
+    {
+        const byte rows[] = {highByte(y0), lowByte(y0), highByte(y1), lowByte(y1)};
+        writeCommand(DisplayCommand::RASET, rows, sizeof(rows));
+        windowY0 = y0;
+        windowY1 = y1;
+        rowsValid = true;
+        sent += RASET_BYTES;
+    }
+    writeCommand(DisplayCommand::RAMWR);
+    savedBytes += WINDOW_BYTES - sent;
+}
+
+void Epson_PNL_CE02_Display::writePixels(const uint16_t *pPixels, size_t count)
+{
+    controlPanel->extenderWrite(ExtenderPin::LCD_DC, HIGH); // no-op within a burst
+    if (currentMode == ColorMode::RGB444)
+    {
+        writeRGB444(count, [pPixels](uint32_t index) { return pPixels[index]; });
+    }
+    else
+    {
+        controlPanel->displayWritePixels(pPixels, count);
+    }
+    advance(count);
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Display::writePixels_P(const uint16_t *pPixels, size_t count)
+{
+    controlPanel->extenderWrite(ExtenderPin::LCD_DC, HIGH); // no-op within a burst
+    if (currentMode == ColorMode::RGB444)
+    {
+        writeRGB444(count, [pPixels](uint32_t index) { return static_cast<uint16_t>(pgm_read_word(pPixels + index)); });
+    }
+    else
+    {
+        controlPanel->displayWritePixels_P(pPixels, count);
+    }
+    advance(count);
+}
+
+void Epson_PNL_CE02_Display::fillPixels(uint16_t color, uint32_t count)
+{
+    controlPanel->extenderWrite(ExtenderPin::LCD_DC, HIGH); // no-op within a burst
+    if (currentMode == ColorMode::RGB444)
+    {
+        // Undithered gray levels 0x000, 0x111... 0xFFF pack in a repeated byte, only strobed
+        const uint16_t packed = color444(color);
+        const byte nibble = packed & 0x0F;
+        const bool exact = color444(color, 0x0F) == packed; // nothing to dither
+        if ((!dithering || exact) && packed == nibble * 0x111)
+        {
+            controlPanel->displayRepeat(nibble * 0x11, packedLength(count));
+        }
+        else
+        {
+            writeRGB444(count, [color](uint32_t) { return color; });
+        }
+    }
+    else
+    {
+        controlPanel->fillColor(color, count);
+    }
+    advance(count);
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Display::writePackedPixels(const byte *pPacked, size_t count)
+{
+    controlPanel->extenderWrite(ExtenderPin::LCD_DC, HIGH); // no-op within a burst
+    controlPanel->displayWriteBuffer(pPacked, packedLength(count));
+    advance(count);
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Display::writePackedPixels_P(const byte *pPacked, size_t count)
+{
+    controlPanel->extenderWrite(ExtenderPin::LCD_DC, HIGH); // no-op within a burst
+    controlPanel->displayWriteBuffer_P(pPacked, packedLength(count));
+    advance(count);
+}
+
+void Epson_PNL_CE02_Display::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT)
+    {
+        return;
+    }
+
+    // Pixels drawn column by column (Adafruit_GFX glyphs) continue a column burst, others a row burst
+    if (x == lastPixelX && y == lastPixelY + 1)
+    {
+        setWindow(x, y, x, HEIGHT - 1);
+    }
+    else
+    {
+        setWindow(x, y, WIDTH - 1, y);
+    }
+    fillPixels(color, 1);
+    lastPixelX = x;
+    lastPixelY = y;
+}
+
+void Epson_PNL_CE02_Display::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    if (!clip(x, y, w, h))
+    {
+        return;
+    }
+    setRegion(x, y, w, h);
+    fillPixels(color, static_cast<uint32_t>(w) * h);
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Display::drawBitmap(int16_t x, int16_t y, const uint16_t *pBitmap, int16_t w, int16_t h)
+{
+    drawClippedBitmap(x, y, w, h,
+                      [this, pBitmap, w](int16_t row, int16_t column, int16_t count) {
+                          writePixels(pBitmap + static_cast<int32_t>(row) * w + column, count);
+                      });
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Display::drawBitmap_P(int16_t x, int16_t y, const uint16_t *pBitmap, int16_t w, int16_t h)
+{
+    drawClippedBitmap(x, y, w, h,
+                      [this, pBitmap, w](int16_t row, int16_t column, int16_t count) {
+                          writePixels_P(pBitmap + static_cast<int32_t>(row) * w + column, count);
+                      });
+}
+
+// cppcheck-suppress unusedFunction
+bool Epson_PNL_CE02_Display::drawImage_P(int16_t x, int16_t y, const byte *pImage)
+{
+    Epson_PNL_CE02_Image image(pImage);
+    if (!image.isValid() || x < 0 || y < 0 || x + image.width() > WIDTH || y + image.height() > HEIGHT)
+    {
+        return false;
+    }
+
+    setRegion(x, y, image.width(), image.height());
+    Epson_PNL_CE02_Image::Packet packet{};
+    if (currentMode == ColorMode::RGB444)
+    {
+        // Pairs of pixels span packets, decoded pixel by pixel
+        const byte bits = image.bitsPerIndex();
+        uint16_t left = 0;
+        byte packed = 0;
+        byte packedLeft = 0;
+        controlPanel->extenderWrite(ExtenderPin::LCD_DC, HIGH);
+        const uint32_t count = static_cast<uint32_t>(image.width()) * image.height();
+        writeRGB444(count, [&](uint32_t) {
+            if (left == 0)
+            {
+                image.nextPacket(packet);
+                left = packet.length;
+                packedLeft = 0;
+            }
+            left--;
+            if (packet.run)
+            {
+                return image.color(packet.index);
+            }
+            if (packedLeft == 0)
+            {
+                packed = pgm_read_byte(packet.pIndexes++);
+                packedLeft = 8 / bits;
+            }
+            const byte index = packed >> (8 - bits);
+            packed <<= bits;
+            packedLeft--;
+            return image.color(index);
+        });
+        advance(count);
+        return true;
+    }
+
+    while (image.nextPacket(packet))
+    {
+        if (packet.run)
+        {
+            fillPixels(image.color(packet.index), packet.length);
+        }
+        else
+        {
+            controlPanel->extenderWrite(ExtenderPin::LCD_DC, HIGH); // no-op within a burst
+            controlPanel->displayWriteIndexed_P(packet.pIndexes, image.bitsPerIndex(), image.palette(), packet.length);
+            advance(packet.length);
+        }
+    }
+    return true;
+}
+
+void Epson_PNL_CE02_Display::setRotation(byte rotation)
+{
+    const byte ROTATIONS[] = {
+        MADCTL_BGR,                         // 0
+        MADCTL_MX | MADCTL_MV | MADCTL_BGR, // 90
+        MADCTL_MX | MADCTL_MY | MADCTL_BGR, // 180
+        MADCTL_MY | MADCTL_MV | MADCTL_BGR, // 270
+    };
+    writeCommand(DisplayCommand::MADCTL, &ROTATIONS[rotation & 0b11], 1);
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Display::invertDisplay(bool invert)
+{
+    writeCommand(invert ? DisplayCommand::INVON : DisplayCommand::INVOFF);
+}
+
+void Epson_PNL_CE02_Display::setColorMode(ColorMode mode, bool dither)
+{
+    const byte colmod = static_cast<byte>(mode);
+    writeCommand(DisplayCommand::COLMOD, &colmod, 1);
+    currentMode = mode;
+    dithering = dither;
+}
+
+// cppcheck-suppress unusedFunction
+ColorMode Epson_PNL_CE02_Display::colorMode() const
+{
+    return currentMode;
+}
+
+// cppcheck-suppress unusedFunction
+uint16_t Epson_PNL_CE02_Display::color565(byte red, byte green, byte blue)
+{
+    return ((red & 0xF8) << 8) | ((green & 0xFC) << 3) | (blue >> 3);
+}
+
+void Epson_PNL_CE02_Display::invalidate()
+{
+    columnsValid = false;
+    rowsValid = false;
+    writing = false;
+}
+
+uint16_t Epson_PNL_CE02_Display::color444(uint16_t color, byte threshold)
+{
+    // Dropped bits (1 for red and blue, 2 for green) are rounded up when above the threshold
+    const byte MAX = 0x0F;
+    const byte red = ((color >> 11) + (threshold >> 3)) >> 1;
+    const byte green = (((color >> 5) & 0x3F) + (threshold >> 2)) >> 2;
+    const byte blue = ((color & 0x1F) + (threshold >> 3)) >> 1;
+    return (red > MAX ? MAX : red) << 8 | (green > MAX ? MAX : green) << 4 | (blue > MAX ? MAX : blue);
+}
+
+// cppcheck-suppress unusedFunction
+uint32_t Epson_PNL_CE02_Display::savedCommandBytes() const
+{
+    return savedBytes;
+}
+
+// PRIVATES
+void Epson_PNL_CE02_Display::writeCommandCode(DisplayCommand command)
+{
+    const byte code = static_cast<byte>(command);
+    controlPanel->extenderWrite(ExtenderPin::LCD_DC, LOW); // command, kept until data are sent
+    controlPanel->displayWriteBuffer(&code, 1);
+
+    switch (command)
+    {
+    case DisplayCommand::CASET:
+        columnsValid = false;
+        break;
+    case DisplayCommand::RASET:
+        rowsValid = false;
+        break;
+    case DisplayCommand::SWRESET:
+        invalidate();
+        break;
+    default:
+        break;
+    }
+    writing = command == DisplayCommand::RAMWR;
+    cursorX = windowX0;
+    cursorY = windowY0;
+}
+
+bool Epson_PNL_CE02_Display::drawSplash(const byte *pSplash)
+{
+    const Epson_PNL_CE02_Image splash(pSplash);
+    if (!splash.isValid())
+    {
+        return false;
+    }
+
+    // Black around the image, each pixel written once
+    const int16_t w = splash.width();
+    const int16_t h = splash.height();
+    const int16_t x = (WIDTH - w) / 2;
+    const int16_t y = (HEIGHT - h) / 2;
+    fillRect(0, 0, WIDTH, y, 0x0000);
+    fillRect(0, y, x, h, 0x0000);
+    fillRect(x + w, y, WIDTH - x - w, h, 0x0000);
+    fillRect(0, y + h, WIDTH, HEIGHT - y - h, 0x0000);
+    return drawImage_P(x, y, pSplash);
+}
+
+bool Epson_PNL_CE02_Display::continuesBurst(int16_t x0, int16_t y0, int16_t x1, int16_t y1) const
+{
+    if (!writing || x0 != cursorX || y0 != cursorY)
+    {
+        return false;
+    }
+    const bool rowRun = y0 == y1 && x1 <= windowX1;                           // rest of the current row
+    const bool nextRows = x0 == windowX0 && x1 == windowX1 && y1 <= windowY1; // next full rows
+    return rowRun || nextRows;
+}
+
+void Epson_PNL_CE02_Display::advance(uint32_t count)
+{
+    if (currentMode == ColorMode::RGB444 && (count & 1) != 0)
+    {
+        writing = false; // half a pair pending in the display, the next pixel would be misaligned
+    }
+    if (!writing)
+    {
+        return;
+    }
+    const uint32_t width = windowX1 - windowX0 + 1;
+    const uint32_t offset = static_cast<uint32_t>(cursorY - windowY0) * width + (cursorX - windowX0) + count;
+    cursorX = windowX0 + offset % width;
+    cursorY = windowY0 + offset / width;
+    if (cursorY > windowY1)
+    {
+        writing = false; // window full, the display wraps to its origin
+    }
+}
+
+void Epson_PNL_CE02_Display::setRegion(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    if (h == 1)
+    {
+        setWindow(x, y, WIDTH - 1, y);
+    }
+    else if (w == 1)
+    {
+        setWindow(x, y, x, HEIGHT - 1);
+    }
+    else
+    {
+        setWindow(x, y, x + w - 1, y + h - 1);
+    }
+}
+
+bool Epson_PNL_CE02_Display::clip(int16_t &x, int16_t &y, int16_t &w, int16_t &h)
+{
+    if (x < 0)
+    {
+        w += x;
+        x = 0;
+    }
+    if (y < 0)
+    {
+        h += y;
+        y = 0;
+    }
+    if (x + w > WIDTH)
+    {
+        w = WIDTH - x;
+    }
+    if (y + h > HEIGHT)
+    {
+        h = HEIGHT - y;
+    }
+    return w > 0 && h > 0;
+}
+
+template <class Row>
+void Epson_PNL_CE02_Display::drawClippedBitmap(int16_t x, int16_t y, int16_t w, int16_t h, Row row)
+{
+    int16_t clippedX = x;
+    int16_t clippedY = y;
+    int16_t clippedW = w;
+    int16_t clippedH = h;
+    if (!clip(clippedX, clippedY, clippedW, clippedH))
+    {
+        return;
+    }
+
+    setRegion(clippedX, clippedY, clippedW, clippedH);
+    if (clippedW == w)
+    {
+        row(clippedY - y, 0, clippedW * clippedH); // contiguous rows, a single stream
+        return;
+    }
+    for (int16_t r = clippedY - y; r < clippedY - y + clippedH; r++)
+    {
+        row(r, clippedX - x, clippedW);
+    }
+}
+
+template <class Pixel> void Epson_PNL_CE02_Display::writeRGB444(uint32_t count, Pixel pixel)
+{
+    byte chunk[PACKED_CHUNK];
+    int16_t x = cursorX;
+    int16_t y = cursorY;
+    auto next = [this, &pixel, &x, &y](uint32_t index) {
+        const byte threshold = dithering ? BAYER[y & 3][x & 3] : 0;
+        if (++x > windowX1)
+        {
+            x = windowX0;
+            y++;
+        }
+        return color444(pixel(index), threshold);
+    };
+
+    uint32_t index = 0;
+    while (index < count)
+    {
+        byte length = 0;
+        while (length < PACKED_CHUNK && index < count)
+        {
+            const uint16_t first = next(index++);
+            chunk[length++] = first >> 4;
+            if (index == count)
+            {
+                chunk[length++] = static_cast<byte>(first << 4); // odd last pixel
+                break;
+            }
+            const uint16_t second = next(index++);
+            chunk[length++] = static_cast<byte>(first << 4) | (second >> 8);
+            chunk[length++] = lowByte(second);
+        }
+        controlPanel->displayWriteBuffer(chunk, length);
+    }
+}
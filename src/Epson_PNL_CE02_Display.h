@@ -0,0 +1,359 @@
+/**
+ * @file Epson_PNL_CE02_Display.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief ILI9163C display driver of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * The GIANTPLUS ILI9163C screen (128x128, RGB565) is wired in write-only 8-bit parallel mode:
+ *  => D0-D7 through the non latched VHC164 (refer to Epson_PNL_CE02::displayWrite)
+ *  => CS and D/C through the VHC595 extender (refer to ExtenderPin)
+ *  => WR and RESET directly on Arduino pins (refer to Epson_PNL_CE02_Pinout)
+ *
+ * Drawing is window-addressed: a rectangle is selected once, then its pixels are streamed.
+ * The current window is cached: unchanged CASET / RASET are skipped, and a rectangle continuing the pixels stream of
+ * the current window (next run of a row, next rows of a column) is appended to the pending RAMWR burst.
+ * In RGB444 mode (refer to setColorMode()), RGB565 pixels are packed by pairs on the fly: 3 bytes per 2 pixels.
+ * Use Epson_PNL_CE02_TFT for an Adafruit_GFX compatible interface.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_DISPLAY_H
+#define EPSON_PNL_CE02_DISPLAY_H
+
+#include <Arduino.h>
+#include <Epson_PNL_CE02.h>
+#include <Epson_PNL_CE02_Image.h>
+
+/**
+ * @brief ILI9163C commands used by the driver.
+ */
+enum class DisplayCommand : byte // NOLINT(readability-identifier-naming): Bug clangtidy v15: enum detected as variable
+{
+    NOP = 0x00,      // No operation, ends the tables of writeCommands_P()
+    SWRESET = 0x01,  // Software reset
+    SLPIN = 0x10,    // Sleep in
+    SLPOUT = 0x11,   // Sleep out
+    NORON = 0x13,    // Normal display mode on
+    INVOFF = 0x20,   // Display inversion off
+    INVON = 0x21,    // Display inversion on
+    GAMSET = 0x26,   // Gamma set
+    DISPOFF = 0x28,  // Display off
+    DISPON = 0x29,   // Display on
+    CASET = 0x2A,    // Column address set
+    RASET = 0x2B,    // Row address set
+    RAMWR = 0x2C,    // Memory write
+    VSCRDEF = 0x33,  // Vertical scrolling definition
+    MADCTL = 0x36,   // Memory access control
+    VSCRSADD = 0x37, // Vertical scrolling start address
+    COLMOD = 0x3A,   // Interface pixel format
+    FRMCTR1 = 0xB1,  // Frame rate control, normal mode
+    INVCTR = 0xB4,   // Display inversion control
+    PWCTR1 = 0xC0,   // Power control 1, GVDD and VCI1
+    PWCTR2 = 0xC1,   // Power control 2, step-up factor
+    VMCTR1 = 0xC5,   // VCOM control 1, VCOMH and VCOML
+    VMOFCTR = 0xC7,  // VCOM offset control
+    PGAMCTRL = 0xE0, // Positive gamma correction
+    NGAMCTRL = 0xE1, // Negative gamma correction
+    GAMRSEL = 0xF2,  // Gamma adjustment enable
+};
+
+/**
+ * @brief Pixel format sent to the display (COLMOD).
+ */
+enum class ColorMode : byte // NOLINT(readability-identifier-naming): Bug clangtidy v15: enum detected as variable
+{
+    RGB444 = 0x03, // 12 bits, 3 bytes per 2 pixels
+    RGB565 = 0x05, // 16 bits, 2 bytes per pixel
+};
+
+/**
+ * @brief ILI9163C driver, window-addressed drawing through Epson_PNL_CE02.
+ *
+ * @example
+ * ``` c++
+ * Epson_PNL_CE02_Display display(&controlPanel);
+ * display.begin();
+ * display.fillRect(0, 0, 128, 128, 0xF800); // red screen
+ * ```
+ */
+class Epson_PNL_CE02_Display // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    static const int16_t WIDTH = 128;
+    static const int16_t HEIGHT = 128;
+
+    /**
+     * @brief Construct a new Epson_PNL_CE02_Display object
+     *
+     * @param pControlPanel Reference to the Epson_PNL_CE02 controlling the display.
+     */
+    explicit Epson_PNL_CE02_Display(Epson_PNL_CE02 *pControlPanel);
+
+    /**
+     * @brief Reset and initialize the display (RGB565), then turn the backlight on.
+     * Epson_PNL_CE02::begin() must be called before.
+     *
+     * The display is configured and its frame memory drawn while it wakes up from the reset: the screen is cleared
+     * (or shows the splash image) and lit together, within the minimum delays of the ILI9163C (about 130 ms).
+     *
+     * @param pSplash compressed image in PROGMEM (refer to Epson_PNL_CE02_Image) shown centered on black,
+     * nullptr for a black screen
+     */
+    void begin(const byte *pSplash = nullptr);
+
+    /**
+     * @brief Send a table of commands stored in flash memory (PROGMEM).
+     * Each entry is the command, its number of parameters (0 to 127, `+ 0x80` when a delay follows), the parameters,
+     * then the delay in milliseconds. The table ends with a 0x00 command (NOP). Parameters are sent straight from flash
+     * memory, no copy in RAM.
+     *
+     * @example
+     * ``` c++
+     * const byte GAMMA[] PROGMEM = {
+     *     0x26, 1, 0x04, // GAMSET: curve 3
+     *     0x00,
+     * };
+     * display.writeCommands_P(GAMMA);
+     * ```
+     *
+     * @param pCommands commands in PROGMEM
+     */
+    // NOLINTNEXTLINE(readability-identifier-naming): Arduino PROGMEM suffix
+    void writeCommands_P(const byte *pCommands);
+
+    /**
+     * @brief micros() when begin() turned the display on: time from the start of the MCU to the first pixel shown.
+     *
+     * @return unsigned long microseconds, 0 before begin()
+     */
+    unsigned long firstPixelMicros() const;
+
+    /**
+     * @brief Send a command followed by its parameters.
+     *
+     * @param command ILI9163C command
+     * @param pParams parameters
+     * @param count number of parameters
+     */
+    void writeCommand(DisplayCommand command, const byte *pParams = nullptr, byte count = 0);
+
+    /**
+     * @brief Select the rectangle receiving the next pixels, inclusive bounds.
+     * Pixels fill the window from left to right then top to bottom.
+     * Commands are skipped when the window is already selected or continues the current pixels stream.
+     *
+     * @param x0 left column
+     * @param y0 top row
+     * @param x1 right column
+     * @param y1 bottom row
+     */
+    void setWindow(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+    /**
+     * @brief Stream pixels (RGB565) in the current window.
+     *
+     * @param pPixels pixels
+     * @param count number of pixels
+     */
+    void writePixels(const uint16_t *pPixels, size_t count);
+
+    /**
+     * @brief Same as writePixels() with pixels stored in flash memory (PROGMEM).
+     *
+     * @param pPixels pixels in PROGMEM
+     * @param count number of pixels
+     */
+    // NOLINTNEXTLINE(readability-identifier-naming): Arduino PROGMEM suffix
+    void writePixels_P(const uint16_t *pPixels, size_t count);
+
+    /**
+     * @brief Stream the same pixel (RGB565) in the current window.
+     *
+     * @param color RGB565 color
+     * @param count number of pixels
+     */
+    void fillPixels(uint16_t color, uint32_t count);
+
+    /**
+     * @brief Stream pixels already packed in RGB444, in the current window. Requires ColorMode::RGB444.
+     * Pairs of pixels are packed in 3 bytes: R0G0 B0R1 G1B1. An odd last pixel takes 2 bytes: R0G0 B0.
+     *
+     * @param pPacked packed pixels
+     * @param count number of pixels
+     */
+    void writePackedPixels(const byte *pPacked, size_t count);
+
+    /**
+     * @brief Same as writePackedPixels() with pixels stored in flash memory (PROGMEM).
+     */
+    // NOLINTNEXTLINE(readability-identifier-naming): Arduino PROGMEM suffix
+    void writePackedPixels_P(const byte *pPacked, size_t count);
+
+    /**
+     * @brief Draw a single pixel, clipped to the screen.
+     */
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
+
+    /**
+     * @brief Fill a rectangle, clipped to the screen.
+     */
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+    /**
+     * @brief Draw a RGB565 bitmap through a single window, clipped to the screen.
+     *
+     * @param x left column
+     * @param y top row
+     * @param pBitmap pixels, row by row
+     * @param w bitmap width
+     * @param h bitmap height
+     */
+    void drawBitmap(int16_t x, int16_t y, const uint16_t *pBitmap, int16_t w, int16_t h);
+
+    /**
+     * @brief Same as drawBitmap() with pixels stored in flash memory (PROGMEM).
+     */
+    // NOLINTNEXTLINE(readability-identifier-naming): Arduino PROGMEM suffix
+    void drawBitmap_P(int16_t x, int16_t y, const uint16_t *pBitmap, int16_t w, int16_t h);
+
+    /**
+     * @brief Draw a compressed image stored in flash memory (PROGMEM), refer to Epson_PNL_CE02_Image.
+     * The image is decoded while streamed through a single window: runs are sent as fills, literal pixels through
+     * the palette.
+     *
+     * @param x left column
+     * @param y top row
+     * @param pImage image in PROGMEM
+     * @return true if drawn, false if the image is invalid or not fully on screen
+     */
+    // NOLINTNEXTLINE(readability-identifier-naming): Arduino PROGMEM suffix
+    bool drawImage_P(int16_t x, int16_t y, const byte *pImage);
+
+    /**
+     * @brief Set the display orientation.
+     *
+     * @param rotation 0 to 3, quarter turns clockwise
+     */
+    void setRotation(byte rotation);
+
+    /**
+     * @brief Invert display colors.
+     *
+     * @param invert true to invert
+     */
+    void invertDisplay(bool invert);
+
+    /**
+     * @brief Select the pixel format sent to the display. begin() selects RGB565.
+     * RGB444 sends 25% less bytes. Pixels are still given in RGB565 and converted, with an optional 4x4 ordered
+     * dithering hiding the bands of the 4-bit gradients.
+     * An odd number of pixels ends the RAMWR burst in RGB444: the next pixels need a new window.
+     *
+     * @param mode pixel format
+     * @param dither true to dither RGB565 pixels converted to RGB444
+     */
+    void setColorMode(ColorMode mode, bool dither = false);
+
+    /**
+     * @brief Get the pixel format sent to the display.
+     */
+    ColorMode colorMode() const;
+
+    /**
+     * @brief Convert a 24-bit color to RGB565.
+     */
+    static uint16_t color565(byte red, byte green, byte blue);
+
+    /**
+     * @brief Convert a RGB565 color to RGB444 (0x0RGB).
+     *
+     * @param color RGB565 color
+     * @param threshold dithering threshold, 0 to 15 (0 truncates)
+     */
+    static uint16_t color444(uint16_t color, byte threshold = 0);
+
+    /**
+     * @brief Forget the cached window, required after driving the display outside of this driver.
+     */
+    void invalidate();
+
+    /**
+     * @brief Command and parameter bytes not sent thanks to the window cache, since begin().
+     * Compare values read before and after an operation to get its savings.
+     *
+     * @return uint32_t saved bytes
+     */
+    uint32_t savedCommandBytes() const;
+
+  private:
+    Epson_PNL_CE02 *controlPanel;
+
+    // Window cache, as selected in the display
+    int16_t windowX0 = 0;
+    int16_t windowY0 = 0;
+    int16_t windowX1 = 0;
+    int16_t windowY1 = 0;
+    bool columnsValid = false;
+    bool rowsValid = false;
+
+    // Next pixel written by the pending RAMWR burst
+    int16_t cursorX = 0;
+    int16_t cursorY = 0;
+    bool writing = false;
+
+    ColorMode currentMode = ColorMode::RGB565;
+    bool dithering = false;
+
+    int16_t lastPixelX = -1;
+    int16_t lastPixelY = -1;
+    uint32_t savedBytes = 0;
+    unsigned long firstPixel = 0;
+
+    /**
+     * @brief Send a command byte and forget what it changes in the window cache, parameters follow with LCD_DC HIGH.
+     */
+    void writeCommandCode(DisplayCommand command);
+
+    /**
+     * @brief Draw a compressed image centered on black, for begin().
+     *
+     * @return true if the image is valid and fits the screen
+     */
+    bool drawSplash(const byte *pSplash);
+
+    /**
+     * @brief Determine if a window continues the pending RAMWR burst.
+     */
+    bool continuesBurst(int16_t x0, int16_t y0, int16_t x1, int16_t y1) const;
+
+    /**
+     * @brief Move the cursor of the pending RAMWR burst after pixels are written.
+     */
+    void advance(uint32_t count);
+
+    /**
+     * @brief Select a rectangle, open-ended when it is a single row or column so the next run continues the burst.
+     */
+    void setRegion(int16_t x, int16_t y, int16_t w, int16_t h);
+
+    /**
+     * @brief Clip a rectangle to the screen.
+     *
+     * @return true if something remains to draw
+     */
+    static bool clip(int16_t &x, int16_t &y, int16_t &w, int16_t &h);
+
+    template <class Row> void drawClippedBitmap(int16_t x, int16_t y, int16_t w, int16_t h, Row row);
+
+    /**
+     * @brief Convert and pack pixels in RGB444, dithered from the position of the cursor.
+     *
+     * @param pixel RGB565 color of the pixel `index`
+     */
+    template <class Pixel> void writeRGB444(uint32_t count, Pixel pixel);
+};
+
+#endif // EPSON_PNL_CE02_DISPLAY_H
@@ -0,0 +1,417 @@
+/**
+ * @file Epson_PNL_CE02_DisplayQueue.cpp
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Asynchronous display transfers of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#include "Epson_PNL_CE02_DisplayQueue.h"
+#include <Arduino.h>
+#include <SPI.h>
+#include <string.h>
+
+namespace
+{
+Epson_PNL_CE02_DisplayQueue *pRunning = nullptr; // queue set up by begin()
+bool spiAttached = false;                        // EPSON_PNL_CE02_DISPLAY_QUEUE_ISR() defined in the sketch
+const uint16_t MAX_SPAN_PIXELS = 0x7FFF;         // span length in bytes fits 16 bits
+
+/**
+ * @brief Determine if the SPI interrupt sends the queued bytes, otherwise poll() does.
+ */
+bool isInterruptDriven()
+{
+#if defined(ARDUINO_ARCH_AVR) && defined(SPI_STC_vect)
+    return spiAttached;
+#else
+    return false;
+#endif
+}
+} // namespace
+
+// CTOR
+Epson_PNL_CE02_DisplayQueue::Epson_PNL_CE02_DisplayQueue(Epson_PNL_CE02 *pControlPanel) : controlPanel(pControlPanel)
+{
+}
+
+// PUBLICS
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_DisplayQueue::begin(uint32_t transferClock)
+{
+    clock = transferClock;
+    pRunning = this;
+}
+
+bool Epson_PNL_CE02_DisplayQueue::enqueueCommand(DisplayCommand command, const byte *pParams, byte count)
+{
+    if (count > MAX_PARAMS || !canReserve(1))
+    {
+        return false;
+    }
+    setCommand(reserved(0), command, pParams, count);
+    publish(1);
+    return true;
+}
+
+bool Epson_PNL_CE02_DisplayQueue::enqueueWindow(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+    if (!canReserve(3))
+    {
+        return false;
+    }
+    reserveWindow(x0, y0, x1, y1);
+    publish(3);
+    return true;
+}
+
+// cppcheck-suppress unusedFunction
+bool Epson_PNL_CE02_DisplayQueue::enqueuePixels(const uint16_t *pPixels, uint16_t count)
+{
+    return enqueueRun(SpanKind::PIXELS, pPixels, 0, count);
+}
+
+// cppcheck-suppress unusedFunction
+bool Epson_PNL_CE02_DisplayQueue::enqueuePixels_P(const uint16_t *pPixels, uint16_t count)
+{
+    return enqueueRun(SpanKind::PIXELS_P, pPixels, 0, count);
+}
+
+// cppcheck-suppress unusedFunction
+bool Epson_PNL_CE02_DisplayQueue::enqueueFill(uint16_t color, uint32_t count)
+{
+    return enqueueRun(SpanKind::FILL, nullptr, color, count);
+}
+
+// cppcheck-suppress unusedFunction
+bool Epson_PNL_CE02_DisplayQueue::enqueueBitmap_P(int16_t x, int16_t y, const uint16_t *pBitmap, int16_t w, int16_t h)
+{
+    const int16_t WIDTH = Epson_PNL_CE02_Display::WIDTH;
+    const int16_t HEIGHT = Epson_PNL_CE02_Display::HEIGHT;
+    if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > WIDTH || y + h > HEIGHT || !canReserve(4))
+    {
+        return false;
+    }
+    reserveWindow(x, y, x + w - 1, y + h - 1);
+    Span &span = reserved(3);
+    span.kind = SpanKind::PIXELS_P;
+    span.length = static_cast<uint16_t>(w) * h * 2; // a full screen is 0x8000 bytes
+    span.pPixels = pBitmap;
+    publish(4);
+    return true;
+}
+
+bool Epson_PNL_CE02_DisplayQueue::isBusy() const
+{
+    return running;
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_DisplayQueue::wait()
+{
+    while (running)
+    {
+        if (!isInterruptDriven())
+        {
+            poll();
+        }
+    }
+}
+
+void Epson_PNL_CE02_DisplayQueue::poll(uint16_t maxBytes)
+{
+    if (isInterruptDriven())
+    {
+        return; // sent by the interrupt
+    }
+    if (!running || Epson_PNL_CE02::busDepth > 0)
+    {
+        return; // a bus transaction is in progress, maybe the one interrupted
+    }
+    const Epson_PNL_CE02::BusOwner owner;
+    byte value = 0;
+    while (maxBytes-- > 0)
+    {
+        if (!nextByte(value))
+        {
+            running = false;
+            return;
+        }
+        Epson_PNL_CE02::shiftedValid = false;
+        SPIClass::transfer(value);
+        controlPanel->displayStrobe();
+        if (Epson_PNL_CE02::busRequested)
+        {
+            Epson_PNL_CE02::serviceBus();
+        }
+    }
+}
+
+void Epson_PNL_CE02_DisplayQueue::step()
+{
+#if defined(ARDUINO_ARCH_AVR) && defined(SPI_STC_vect)
+    controlPanel->displayStrobe();
+    inFlight = false;
+    stepping = true;
+    if (Epson_PNL_CE02::busRequested)
+    {
+        const Epson_PNL_CE02::BusOwner owner; // runs the handler when released
+    }
+
+    byte value = 0;
+    if (nextByte(value))
+    {
+        Epson_PNL_CE02::shiftedValid = false;
+        SPDR = value;
+        inFlight = true;
+    }
+    else
+    {
+        finish();
+    }
+    stepping = false;
+#endif
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_DisplayQueue::spiInterrupt()
+{
+    if (pRunning != nullptr)
+    {
+        pRunning->step();
+    }
+}
+
+// cppcheck-suppress unusedFunction
+bool Epson_PNL_CE02_DisplayQueue::attachSpiInterrupt()
+{
+    spiAttached = true;
+    return true;
+}
+
+// PRIVATES
+Epson_PNL_CE02_DisplayQueue::Span &Epson_PNL_CE02_DisplayQueue::reserved(byte index)
+{
+    return spans[(head + index) & (QUEUE_SIZE - 1)];
+}
+
+bool Epson_PNL_CE02_DisplayQueue::canReserve(byte count) const
+{
+    const byte used = (head - tail) & (QUEUE_SIZE - 1);
+    return used + count < QUEUE_SIZE; // a slot stays empty to tell a full queue from an empty one
+}
+
+void Epson_PNL_CE02_DisplayQueue::publish(byte count)
+{
+    head = (head + count) & (QUEUE_SIZE - 1); // publish once written
+    if (!running)
+    {
+        start(); // the interrupt has nothing left to send, it cannot run concurrently
+    }
+}
+
+bool Epson_PNL_CE02_DisplayQueue::enqueueRun(SpanKind kind, const uint16_t *pPixels, uint16_t color, uint32_t count)
+{
+    if (count == 0)
+    {
+        return true;
+    }
+    const uint32_t needed = (count + MAX_SPAN_PIXELS - 1) / MAX_SPAN_PIXELS;
+    if (needed >= QUEUE_SIZE || !canReserve(static_cast<byte>(needed)))
+    {
+        return false;
+    }
+
+    for (byte index = 0; index < needed; index++)
+    {
+        const uint16_t pixels = count > MAX_SPAN_PIXELS ? MAX_SPAN_PIXELS : count;
+        Span &span = reserved(index);
+        span.kind = kind;
+        span.length = pixels * 2;
+        span.color = color;
+        span.pPixels = pPixels;
+        if (pPixels != nullptr)
+        {
+            pPixels += pixels;
+        }
+        count -= pixels;
+    }
+    publish(static_cast<byte>(needed));
+    return true;
+}
+
+void Epson_PNL_CE02_DisplayQueue::reserveWindow(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+    const byte columns[] = {highByte(x0), lowByte(x0), highByte(x1), lowByte(x1)};
+    const byte rows[] = {highByte(y0), lowByte(y0), highByte(y1), lowByte(y1)};
+    setCommand(reserved(0), DisplayCommand::CASET, columns, sizeof(columns));
+    setCommand(reserved(1), DisplayCommand::RASET, rows, sizeof(rows));
+    setCommand(reserved(2), DisplayCommand::RAMWR, nullptr, 0);
+}
+
+void Epson_PNL_CE02_DisplayQueue::setCommand(Span &span, DisplayCommand command, const byte *pParams, byte count)
+{
+    span.kind = SpanKind::COMMAND;
+    span.length = 1 + count;
+    span.bytes[0] = static_cast<byte>(command);
+    if (count > 0)
+    {
+        memcpy(&span.bytes[1], pParams, count);
+    }
+}
+
+bool Epson_PNL_CE02_DisplayQueue::nextByte(byte &value)
+{
+    while (tail != head)
+    {
+        const Span &span = spans[tail];
+        if (position < span.length)
+        {
+            const uint16_t index = position++;
+            bool data = true;
+            switch (span.kind)
+            {
+            case SpanKind::COMMAND:
+                value = span.bytes[index];
+                data = index > 0;
+                break;
+            case SpanKind::PIXELS:
+                value = (index & 1) != 0 ? lowByte(span.pPixels[index >> 1]) : highByte(span.pPixels[index >> 1]);
+                break;
+            case SpanKind::PIXELS_P: {
+                const uint16_t pixel = pgm_read_word(span.pPixels + (index >> 1));
+                value = (index & 1) != 0 ? lowByte(pixel) : highByte(pixel);
+                break;
+            }
+            default: // FILL
+                value = (index & 1) != 0 ? lowByte(span.color) : highByte(span.color);
+                break;
+            }
+
+            // Latched LCD_DC is checked on every byte: a bus transaction may have latched another value
+            const byte dc = data ? HIGH : LOW;
+            if (!controlPanel->latchedValid || bitRead(controlPanel->latched, (byte)ExtenderPin::LCD_DC) != dc)
+            {
+                controlPanel->extenderWriteNow(ExtenderPin::LCD_DC, dc);
+            }
+#if defined(EPSON_PNL_CE02_STATS)
+            Epson_PNL_CE02::statistics.displayBytes++;
+            Epson_PNL_CE02::statistics.writeStrobes++;
+#endif
+            return true;
+        }
+        position = 0;
+        tail = (tail + 1) & (QUEUE_SIZE - 1); // release the span once sent
+    }
+    return false;
+}
+
+void Epson_PNL_CE02_DisplayQueue::start()
+{
+    running = true;
+    paused = false;
+    inFlight = false;
+    if (!isInterruptDriven())
+    {
+        return; // sent by poll()
+    }
+#if defined(ARDUINO_ARCH_AVR) && defined(SPI_STC_vect)
+    busControl = SPCR;
+    busStatus = SPSR;
+    SPIClass::beginTransaction(SPISettings(clock, MSBFIRST, SPI_MODE0));
+    transferControl = SPCR;
+    transferStatus = SPSR;
+
+    byte value = 0;
+    if (!nextByte(value))
+    {
+        finish();
+        return;
+    }
+    // From now on, bus transactions pause the transfer and requested handlers are run between bytes
+    Epson_PNL_CE02::busSuspend = suspendHandler;
+    Epson_PNL_CE02::busResume = resumeHandler;
+    Epson_PNL_CE02::shiftedValid = false;
+    SPDR = value;
+    inFlight = true;
+    SPCR |= _BV(SPIE);
+#endif
+}
+
+void Epson_PNL_CE02_DisplayQueue::finish()
+{
+    running = false;
+    paused = false;
+    inFlight = false;
+#if defined(ARDUINO_ARCH_AVR) && defined(SPI_STC_vect)
+    Epson_PNL_CE02::busSuspend = nullptr;
+    Epson_PNL_CE02::busResume = nullptr;
+    SPCR = busControl; // interrupt disabled
+    SPSR = busStatus;
+    Epson_PNL_CE02::shiftedValid = false;
+    if (Epson_PNL_CE02::busRequested)
+    {
+        const Epson_PNL_CE02::BusOwner owner; // runs the handler deferred by requestBus()
+    }
+#endif
+}
+
+void Epson_PNL_CE02_DisplayQueue::suspendHandler()
+{
+#if defined(ARDUINO_ARCH_AVR) && defined(SPI_STC_vect)
+    // Checked with interrupts disabled: the SPI interrupt may send the last byte and finish() meanwhile
+    const byte status = SREG;
+    cli();
+    Epson_PNL_CE02_DisplayQueue *queue = pRunning;
+    if (queue == nullptr || queue->stepping || queue->paused || !queue->running)
+    {
+        SREG = status;
+        return;
+    }
+    SPCR &= ~_BV(SPIE);
+    if (queue->inFlight)
+    {
+        while ((SPSR & _BV(SPIF)) == 0)
+        {
+        }
+        (void)SPDR; // clears SPIF
+        queue->controlPanel->displayStrobe();
+        queue->inFlight = false;
+    }
+    SPCR = queue->busControl; // bus transactions at their own clock
+    SPSR = queue->busStatus;
+    queue->paused = true;
+    SREG = status;
+#endif
+}
+
+void Epson_PNL_CE02_DisplayQueue::resumeHandler()
+{
+#if defined(ARDUINO_ARCH_AVR) && defined(SPI_STC_vect)
+    Epson_PNL_CE02_DisplayQueue *queue = pRunning;
+    if (queue == nullptr || !queue->paused)
+    {
+        return;
+    }
+    queue->paused = false;
+    queue->stepping = true;
+    SPCR = queue->transferControl;
+    SPSR = queue->transferStatus;
+
+    byte value = 0;
+    if (queue->nextByte(value))
+    {
+        Epson_PNL_CE02::shiftedValid = false;
+        SPDR = value;
+        queue->inFlight = true;
+        SPCR |= _BV(SPIE);
+    }
+    else
+    {
+        queue->finish();
+    }
+    queue->stepping = false;
+#endif
+}
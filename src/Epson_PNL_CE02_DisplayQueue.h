@@ -0,0 +1,271 @@
+/**
+ * @file Epson_PNL_CE02_DisplayQueue.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Asynchronous display transfers of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * Display transfers (commands, pixels, fills) are queued, then sent byte by byte from the SPI transfer complete
+ * interrupt while loop() runs. The bus stays shared:
+ *  => a bus transaction of loop() (synchronize(), readButtons(), ...) pauses the transfer after the byte in flight,
+ *     the transfer resumes when the transaction ends
+ *  => a bus handler requested from an interrupt (refer to Epson_PNL_CE02::requestBus()) runs between two bytes
+ *  => LCD_DC is switched by the transfer itself, and restored if a transaction latched another value
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_DISPLAY_QUEUE_H
+#define EPSON_PNL_CE02_DISPLAY_QUEUE_H
+
+#include <Arduino.h>
+#include <Epson_PNL_CE02.h>
+#include <Epson_PNL_CE02_Display.h>
+
+#ifndef EPSON_PNL_CE02_DISPLAY_QUEUE_SIZE
+#define EPSON_PNL_CE02_DISPLAY_QUEUE_SIZE 8 // power of two
+#endif
+
+/**
+ * @brief Display transfers queue, sent in the background.
+ *
+ * On AVR, bytes are sent from the SPI interrupt, once the sketch defines it with EPSON_PNL_CE02_DISPLAY_QUEUE_ISR().
+ * An interrupt per byte costs ~5 µs of CPU at 16 MHz: the transfer runs at a slower SPI clock (F_CPU / 16 by default)
+ * so that about half of the CPU remains for loop().
+ * On other architectures, or without the interrupt, call poll() from a timer interrupt or from loop().
+ *
+ * The queue drives the display behind Epson_PNL_CE02_Display: do not draw with the display while isBusy(), and call
+ * Epson_PNL_CE02_Display::invalidate() after queuing windows. Pixels are sent as is, in ColorMode::RGB565.
+ *
+ * @example
+ * ``` c++
+ * Epson_PNL_CE02_DisplayQueue queue(&controlPanel);
+ * EPSON_PNL_CE02_DISPLAY_QUEUE_ISR(); // once in the sketch
+ *
+ * queue.begin();
+ * queue.enqueueWindow(0, 0, 127, 127);
+ * queue.enqueueFill(0xF800, 128UL * 128); // red screen, while loop() goes on
+ * ```
+ */
+class Epson_PNL_CE02_DisplayQueue // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    static const byte QUEUE_SIZE = EPSON_PNL_CE02_DISPLAY_QUEUE_SIZE;
+
+    /**
+     * @brief Parameters of a queued command, at most.
+     */
+    static const byte MAX_PARAMS = 4;
+
+    /**
+     * @brief Construct a new Epson_PNL_CE02_DisplayQueue object
+     *
+     * @param pControlPanel Reference to the Epson_PNL_CE02 controlling the display.
+     */
+    explicit Epson_PNL_CE02_DisplayQueue(Epson_PNL_CE02 *pControlPanel);
+
+    /**
+     * @brief Set up the queue. A single queue can transfer at a time.
+     * Epson_PNL_CE02_Display::begin() must be called before.
+     *
+     * @param transferClock SPI clock of the interrupt-driven transfer (AVR)
+     */
+    void begin(uint32_t transferClock = F_CPU / 16);
+
+    /**
+     * @brief Queue a command followed by its parameters.
+     *
+     * @param command ILI9163C command
+     * @param pParams parameters, copied
+     * @param count number of parameters, up to MAX_PARAMS
+     * @return true if queued, false if the queue is full
+     */
+    bool enqueueCommand(DisplayCommand command, const byte *pParams = nullptr, byte count = 0);
+
+    /**
+     * @brief Queue the selection of a window, inclusive bounds (refer to Epson_PNL_CE02_Display::setWindow()).
+     * The whole selection (CASET, RASET, RAMWR) is queued or nothing.
+     *
+     * @return true if queued, false if the queue is full
+     */
+    bool enqueueWindow(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+    /**
+     * @brief Queue pixels (RGB565) for the current window. Pixels are not copied and must stay unchanged until sent.
+     *
+     * @param pPixels pixels
+     * @param count number of pixels
+     * @return true if queued, false if the queue is full
+     */
+    bool enqueuePixels(const uint16_t *pPixels, uint16_t count);
+
+    /**
+     * @brief Same as enqueuePixels() with pixels stored in flash memory (PROGMEM).
+     */
+    // NOLINTNEXTLINE(readability-identifier-naming): Arduino PROGMEM suffix
+    bool enqueuePixels_P(const uint16_t *pPixels, uint16_t count);
+
+    /**
+     * @brief Queue the same pixel (RGB565) for the current window.
+     *
+     * @param color RGB565 color
+     * @param count number of pixels
+     * @return true if queued, false if the queue is full
+     */
+    bool enqueueFill(uint16_t color, uint32_t count);
+
+    /**
+     * @brief Queue a RGB565 bitmap stored in flash memory (PROGMEM), window included.
+     *
+     * @param x left column
+     * @param y top row
+     * @param pBitmap pixels in PROGMEM, row by row
+     * @param w bitmap width
+     * @param h bitmap height
+     * @return true if queued, false if the queue is full or the bitmap is not fully on screen
+     */
+    // NOLINTNEXTLINE(readability-identifier-naming): Arduino PROGMEM suffix
+    bool enqueueBitmap_P(int16_t x, int16_t y, const uint16_t *pBitmap, int16_t w, int16_t h);
+
+    /**
+     * @brief Determine if transfers are queued or in progress.
+     *
+     * @return true
+     * @return false
+     */
+    bool isBusy() const;
+
+    /**
+     * @brief Wait for the queued transfers to be sent.
+     */
+    void wait();
+
+    /**
+     * @brief Send some queued bytes, when no interrupt drives the transfer. Does nothing while the bus is owned.
+     *
+     * @param maxBytes bytes sent at most
+     */
+    void poll(uint16_t maxBytes = 64);
+
+    /**
+     * @brief SPI transfer complete, strobe the byte and send the next one. Called by the SPI interrupt on AVR.
+     */
+    void step();
+
+    /**
+     * @brief SPI transfer complete interrupt, defined in the sketch by EPSON_PNL_CE02_DISPLAY_QUEUE_ISR().
+     */
+    static void spiInterrupt();
+
+    /**
+     * @brief Send the queued bytes from the SPI interrupt. Called by EPSON_PNL_CE02_DISPLAY_QUEUE_ISR().
+     *
+     * @return true
+     */
+    static bool attachSpiInterrupt();
+
+  private:
+    static_assert((QUEUE_SIZE & (QUEUE_SIZE - 1)) == 0, "EPSON_PNL_CE02_DISPLAY_QUEUE_SIZE must be a power of two");
+
+    enum class SpanKind : byte
+    {
+        COMMAND,  // command byte, then parameters
+        PIXELS,   // RAM pixels
+        PIXELS_P, // PROGMEM pixels
+        FILL,     // repeated pixel
+    };
+
+    struct Span
+    {
+        SpanKind kind;
+        uint16_t length; // bytes
+        uint16_t color;  // FILL
+        union {
+            byte bytes[1 + MAX_PARAMS]; // COMMAND
+            const uint16_t *pPixels;    // PIXELS, PIXELS_P
+        };
+    };
+
+    Epson_PNL_CE02 *controlPanel;
+    uint32_t clock{0};
+
+    // Ring buffer: `head` is only written by enqueue, `tail` only by the transfer
+    Span spans[QUEUE_SIZE];
+    volatile byte head{0};
+    volatile byte tail{0};
+    uint16_t position{0}; // bytes of spans[tail] sent
+
+    volatile bool running{false};  // spans left to send
+    volatile bool paused{false};   // interrupt disabled by a bus transaction
+    volatile bool inFlight{false}; // byte shifting, not strobed yet
+    volatile bool stepping{false}; // transfer code running, bus transactions are its own
+
+    // SPI registers (SPCR, SPSR) of bus transactions and of the transfer
+    byte busControl{0};
+    byte busStatus{0};
+    byte transferControl{0};
+    byte transferStatus{0};
+
+    /**
+     * @brief Get a free span, not published yet.
+     *
+     * @param index 0 for the first free span
+     */
+    Span &reserved(byte index);
+
+    /**
+     * @brief Determine if `count` spans are free.
+     */
+    bool canReserve(byte count) const;
+
+    /**
+     * @brief Publish reserved spans and start the transfer.
+     */
+    void publish(byte count);
+
+    /**
+     * @brief Queue pixels, split in spans of 0x7FFF pixels at most.
+     */
+    bool enqueueRun(SpanKind kind, const uint16_t *pPixels, uint16_t color, uint32_t count);
+
+    /**
+     * @brief Fill the first 3 reserved spans with a window selection.
+     */
+    void reserveWindow(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+    static void setCommand(Span &span, DisplayCommand command, const byte *pParams, byte count);
+
+    /**
+     * @brief Get the next byte to send and set LCD_DC accordingly.
+     *
+     * @return true if a byte was fetched, false if the queue is empty
+     */
+    bool nextByte(byte &value);
+
+    void start();
+    void finish();
+
+    /**
+     * @brief Bus transaction hooks (refer to Epson_PNL_CE02::BusOwner).
+     */
+    static void suspendHandler();
+    static void resumeHandler();
+};
+
+/**
+ * @brief Define the SPI transfer complete interrupt of the queue, once in the sketch (AVR).
+ * The library does not define it: sketches not using the queue keep the vector for other SPI code.
+ */
+#if defined(ARDUINO_ARCH_AVR) && defined(SPI_STC_vect)
+#define EPSON_PNL_CE02_DISPLAY_QUEUE_ISR()                                                                             \
+    ISR(SPI_STC_vect)                                                                                                  \
+    {                                                                                                                  \
+        Epson_PNL_CE02_DisplayQueue::spiInterrupt();                                                                   \
+    }                                                                                                                  \
+    static const bool EPSON_PNL_CE02_DISPLAY_QUEUE_ATTACHED = Epson_PNL_CE02_DisplayQueue::attachSpiInterrupt()
+#else
+#define EPSON_PNL_CE02_DISPLAY_QUEUE_ISR() static_assert(true, "call poll() to send the queued bytes")
+#endif
+
+#endif // EPSON_PNL_CE02_DISPLAY_QUEUE_H
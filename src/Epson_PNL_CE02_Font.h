@@ -0,0 +1,39 @@
+/**
+ * @file Epson_PNL_CE02_Font.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Fixed-width PROGMEM fonts of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * Glyphs are 1-bit bitmaps of the whole character cell, spacing included, so that a string is a plain rectangle:
+ *  => `height` rows per glyph, `(width + 7) / 8` bytes per row, most significant bit on the left
+ *  => glyphs of the characters `first` to `last`, in order
+ *
+ * Fonts are generated from BDF files by extras/font_converter.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_FONT_H
+#define EPSON_PNL_CE02_FONT_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Fixed-width font, glyphs stored in flash memory (PROGMEM).
+ */
+struct Epson_PNL_CE02_Font // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+    const byte *pGlyphs; // glyphs in PROGMEM
+    byte width;          // character cell, 1 to 32 pixels
+    byte height;         // character cell, 1 to 255 pixels
+    byte first;          // first character
+    byte last;           // last character
+};
+
+/**
+ * @brief Built-in 5x7 font in 6x8 cells, printable ASCII characters (760 bytes of PROGMEM).
+ */
+extern const Epson_PNL_CE02_Font EPSON_PNL_CE02_FONT_6X8;
+
+#endif // EPSON_PNL_CE02_FONT_H
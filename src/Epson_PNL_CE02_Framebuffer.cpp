@@ -0,0 +1,271 @@
+/**
+ * @file Epson_PNL_CE02_Framebuffer.cpp
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Palette framebuffer of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#include "Epson_PNL_CE02_Framebuffer.h"
+#include <Arduino.h>
+#include <string.h>
+
+namespace
+{
+const byte CHUNK_PIXELS = 32; // converted pixels streamed at once
+const uint16_t ALL_TILES = 0xFFFF;
+
+/**
+ * @brief Fill the bits [first, last[ of a row, most significant bits first.
+ */
+void fillBits(byte *pRow, uint16_t first, uint16_t last, byte pattern)
+{
+    byte *pByte = pRow + first / 8;
+    const byte headBits = first % 8;
+    if (headBits != 0)
+    {
+        const byte headRoom = 8 - headBits;
+        const byte span = (last - first) < headRoom ? static_cast<byte>(last - first) : headRoom;
+        const byte mask = static_cast<byte>((0xFF >> headBits) & ~(0xFF >> (headBits + span)));
+        *pByte = (*pByte & ~mask) | (pattern & mask);
+        pByte++;
+        first += span;
+    }
+    const uint16_t bytes = (last - first) / 8;
+    memset(pByte, pattern, bytes);
+    pByte += bytes;
+    const byte tailBits = (last - first) % 8;
+    if (tailBits != 0)
+    {
+        const byte mask = static_cast<byte>(~(0xFF >> tailBits));
+        *pByte = (*pByte & ~mask) | (pattern & mask);
+    }
+}
+} // namespace
+
+// CTOR
+Epson_PNL_CE02_Framebuffer::Epson_PNL_CE02_Framebuffer(Epson_PNL_CE02_Display *pDisplay, PixelDepth depth,
+                                                       byte *pBuffer)
+    : display(pDisplay), buffer(pBuffer), depth(static_cast<byte>(depth)), palette(), dirty()
+{
+    const byte colors = 1 << this->depth;
+    for (byte index = 0; index < colors; index++)
+    {
+        const byte level = index * 0xFF / (colors - 1);
+        palette[index] = Epson_PNL_CE02_Display::color565(level, level, level);
+    }
+    fillScreen(0);
+}
+
+// PUBLICS
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Framebuffer::setPaletteColor(byte index, uint16_t color)
+{
+    if (index >= (1 << depth))
+    {
+        return;
+    }
+    palette[index] = color;
+    markDirty(0, 0, WIDTH, HEIGHT);
+}
+
+// cppcheck-suppress unusedFunction
+uint16_t Epson_PNL_CE02_Framebuffer::paletteColor(byte index) const
+{
+    return palette[index & 0x0F];
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Framebuffer::drawPixel(int16_t x, int16_t y, byte index)
+{
+    if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT)
+    {
+        return;
+    }
+    const uint16_t bit = (static_cast<uint16_t>(y) * WIDTH + x) * depth;
+    const byte shift = 8 - depth - bit % 8;
+    const byte mask = ((1 << depth) - 1) << shift;
+    byte &pixels = buffer[bit / 8];
+    pixels = (pixels & ~mask) | ((index << shift) & mask);
+    dirty[y / TILE_SIZE] |= 1U << (x / TILE_SIZE);
+}
+
+// cppcheck-suppress unusedFunction
+byte Epson_PNL_CE02_Framebuffer::getPixel(int16_t x, int16_t y) const
+{
+    if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT)
+    {
+        return 0;
+    }
+    const uint16_t bit = (static_cast<uint16_t>(y) * WIDTH + x) * depth;
+    return (buffer[bit / 8] >> (8 - depth - bit % 8)) & ((1 << depth) - 1);
+}
+
+void Epson_PNL_CE02_Framebuffer::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, byte index)
+{
+    if (x < 0)
+    {
+        w += x;
+        x = 0;
+    }
+    if (y < 0)
+    {
+        h += y;
+        y = 0;
+    }
+    if (x + w > WIDTH)
+    {
+        w = WIDTH - x;
+    }
+    if (y + h > HEIGHT)
+    {
+        h = HEIGHT - y;
+    }
+    if (w <= 0 || h <= 0)
+    {
+        return;
+    }
+
+    // Index repeated in a whole byte
+    byte pattern = index & ((1 << depth) - 1);
+    for (byte bits = depth; bits < 8; bits *= 2)
+    {
+        pattern |= pattern << bits;
+    }
+
+    const uint16_t rowBytes = WIDTH * depth / 8;
+    byte *pRow = buffer + static_cast<uint16_t>(y) * rowBytes;
+    for (int16_t row = 0; row < h; row++)
+    {
+        fillBits(pRow, x * depth, (x + w) * depth, pattern);
+        pRow += rowBytes;
+    }
+    markDirty(x, y, w, h);
+}
+
+void Epson_PNL_CE02_Framebuffer::fillScreen(byte index)
+{
+    fillRect(0, 0, WIDTH, HEIGHT, index);
+}
+
+void Epson_PNL_CE02_Framebuffer::markDirty(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    if (x < 0)
+    {
+        w += x;
+        x = 0;
+    }
+    if (y < 0)
+    {
+        h += y;
+        y = 0;
+    }
+    if (w <= 0 || h <= 0 || x >= WIDTH || y >= HEIGHT)
+    {
+        return;
+    }
+    const byte firstColumn = x / TILE_SIZE;
+    const byte lastColumn = (x + w - 1 < WIDTH ? x + w - 1 : WIDTH - 1) / TILE_SIZE;
+    const byte lastRow = (y + h - 1 < HEIGHT ? y + h - 1 : HEIGHT - 1) / TILE_SIZE;
+    const uint16_t columns = static_cast<uint16_t>(ALL_TILES >> (TILE_COLUMNS - 1 - lastColumn + firstColumn))
+                             << firstColumn;
+    for (byte row = y / TILE_SIZE; row <= lastRow; row++)
+    {
+        dirty[row] |= columns;
+    }
+}
+
+// cppcheck-suppress unusedFunction
+bool Epson_PNL_CE02_Framebuffer::isDirty() const
+{
+    for (byte row = 0; row < TILE_ROWS; row++)
+    {
+        if (dirty[row] != 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t Epson_PNL_CE02_Framebuffer::flush()
+{
+    uint16_t sent = 0;
+    for (byte row = 0; row < TILE_ROWS; row++)
+    {
+        while (dirty[row] != 0)
+        {
+            // First run of dirty tiles on the row
+            const uint16_t tiles = dirty[row];
+            byte first = 0;
+            while ((tiles & (1U << first)) == 0)
+            {
+                first++;
+            }
+            byte columns = 1;
+            while (first + columns < TILE_COLUMNS && (tiles & (1U << (first + columns))) != 0)
+            {
+                columns++;
+            }
+            const uint16_t run = static_cast<uint16_t>(ALL_TILES >> (TILE_COLUMNS - columns)) << first;
+
+            // Following rows with the whole run dirty share the window
+            byte rows = 1;
+            while (row + rows < TILE_ROWS && (dirty[row + rows] & run) == run)
+            {
+                rows++;
+            }
+            for (byte cleared = row; cleared < row + rows; cleared++)
+            {
+                dirty[cleared] &= ~run;
+            }
+
+            sendTiles(first, row, columns, rows);
+            sent += static_cast<uint16_t>(columns) * rows * TILE_SIZE * TILE_SIZE;
+        }
+    }
+    return sent;
+}
+
+// PRIVATES
+void Epson_PNL_CE02_Framebuffer::sendTiles(byte column, byte row, byte columns, byte rows)
+{
+    const int16_t x = column * TILE_SIZE;
+    const int16_t y = row * TILE_SIZE;
+    const int16_t w = columns * TILE_SIZE;
+    const int16_t h = rows * TILE_SIZE;
+    display->setWindow(x, y, x + w - 1, y + h - 1);
+
+    // Tiles are byte aligned whatever the depth, rows of the window are streamed back to back
+    const uint16_t rowBytes = WIDTH * depth / 8;
+    const uint16_t spanBytes = w * depth / 8;
+    const byte pixelsPerByte = 8 / depth;
+    const byte indexShift = 8 - depth;
+    uint16_t chunk[CHUNK_PIXELS];
+    byte count = 0;
+    const byte *pRow = buffer + static_cast<uint16_t>(y) * rowBytes + x * depth / 8;
+    for (int16_t line = 0; line < h; line++)
+    {
+        for (uint16_t offset = 0; offset < spanBytes; offset++)
+        {
+            byte pixels = pRow[offset];
+            for (byte pixel = 0; pixel < pixelsPerByte; pixel++)
+            {
+                chunk[count++] = palette[pixels >> indexShift];
+                pixels <<= depth;
+                if (count == CHUNK_PIXELS)
+                {
+                    display->writePixels(chunk, count);
+                    count = 0;
+                }
+            }
+        }
+        pRow += rowBytes;
+    }
+    if (count > 0)
+    {
+        display->writePixels(chunk, count);
+    }
+}
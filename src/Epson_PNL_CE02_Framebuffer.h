@@ -0,0 +1,155 @@
+/**
+ * @file Epson_PNL_CE02_Framebuffer.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Palette framebuffer of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * The display is write-only: pixels cannot be read back to be modified. The framebuffer keeps an off-screen copy of
+ * the screen with palette indexes (1, 2 or 4 bits per pixel), split in 8x8 tiles. Drawing only marks tiles as
+ * dirty, then flush() sends the dirty tiles through Epson_PNL_CE02_Display, merged in as few windows as possible.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_FRAMEBUFFER_H
+#define EPSON_PNL_CE02_FRAMEBUFFER_H
+
+#include <Arduino.h>
+#include <Epson_PNL_CE02_Display.h>
+
+/**
+ * @brief Bits per pixel of a framebuffer, the palette has 2, 4 or 16 colors.
+ */
+enum class PixelDepth : byte // NOLINT(readability-identifier-naming): Bug clangtidy v15: enum detected as variable
+{
+    ONE_BIT = 1,
+    TWO_BITS = 2,
+    FOUR_BITS = 4,
+};
+
+/**
+ * @brief Palette-indexed framebuffer with dirty tiles.
+ *
+ * SRAM used by the buffer: 2 KB (1 bit), 4 KB (2 bits), 8 KB (4 bits, too much for a MEGA 2560).
+ * The palette starts as a gray ramp from black to white.
+ *
+ * @example
+ * ``` c++
+ * byte pixels[Epson_PNL_CE02_Framebuffer::bufferSize(PixelDepth::TWO_BITS)];
+ * Epson_PNL_CE02_Framebuffer framebuffer(&display, PixelDepth::TWO_BITS, pixels);
+ * framebuffer.setPaletteColor(1, 0xF800); // red
+ * framebuffer.fillRect(10, 10, 20, 8, 1);
+ * framebuffer.flush(); // sends 3 tiles
+ * ```
+ */
+class Epson_PNL_CE02_Framebuffer // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    static const int16_t WIDTH = Epson_PNL_CE02_Display::WIDTH;
+    static const int16_t HEIGHT = Epson_PNL_CE02_Display::HEIGHT;
+    static const byte TILE_SIZE = 8;
+    static const byte TILE_COLUMNS = WIDTH / TILE_SIZE;
+    static const byte TILE_ROWS = HEIGHT / TILE_SIZE;
+
+    /**
+     * @brief Size of the buffer holding the pixels.
+     *
+     * @param depth bits per pixel
+     * @return size_t size in bytes
+     */
+    static constexpr size_t bufferSize(PixelDepth depth)
+    {
+        return static_cast<size_t>(WIDTH) * HEIGHT * static_cast<byte>(depth) / 8;
+    }
+
+    /**
+     * @brief Construct a new Epson_PNL_CE02_Framebuffer object, cleared to color 0, every tile dirty.
+     *
+     * @param pDisplay Reference to the display receiving flushed tiles.
+     * @param depth bits per pixel
+     * @param pBuffer pixels, bufferSize(depth) bytes
+     */
+    Epson_PNL_CE02_Framebuffer(Epson_PNL_CE02_Display *pDisplay, PixelDepth depth, byte *pBuffer);
+
+    /**
+     * @brief Set a palette color, every tile becomes dirty.
+     *
+     * @param index palette index
+     * @param color RGB565 color
+     */
+    void setPaletteColor(byte index, uint16_t color);
+
+    /**
+     * @brief Get a palette color.
+     *
+     * @param index palette index
+     * @return uint16_t RGB565 color
+     */
+    uint16_t paletteColor(byte index) const;
+
+    /**
+     * @brief Draw a single pixel, clipped to the screen.
+     *
+     * @param index palette index
+     */
+    void drawPixel(int16_t x, int16_t y, byte index);
+
+    /**
+     * @brief Get a pixel.
+     *
+     * @return byte palette index, 0 outside of the screen
+     */
+    byte getPixel(int16_t x, int16_t y) const;
+
+    /**
+     * @brief Fill a rectangle, clipped to the screen.
+     *
+     * @param index palette index
+     */
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, byte index);
+
+    /**
+     * @brief Fill the whole screen.
+     *
+     * @param index palette index
+     */
+    void fillScreen(byte index);
+
+    /**
+     * @brief Mark the tiles of a rectangle as dirty, to be sent by the next flush().
+     */
+    void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+
+    /**
+     * @brief Determine if tiles are waiting for flush().
+     *
+     * @return true
+     * @return false
+     */
+    bool isDirty() const;
+
+    /**
+     * @brief Send dirty tiles to the display.
+     * Adjacent dirty tiles are merged: a run of tiles on a tile row, extended to the following tile rows having the
+     * same run dirty, is sent through a single window.
+     *
+     * @return uint16_t number of pixels sent
+     */
+    uint16_t flush();
+
+  private:
+    Epson_PNL_CE02_Display *display;
+    byte *buffer;
+    byte depth;
+    uint16_t palette[16];
+    uint16_t dirty[TILE_ROWS]; // a bit per tile column
+
+    /**
+     * @brief Send a rectangle of tiles through a single window.
+     */
+    void sendTiles(byte column, byte row, byte columns, byte rows);
+};
+
+#endif // EPSON_PNL_CE02_FRAMEBUFFER_H
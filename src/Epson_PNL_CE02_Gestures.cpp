@@ -0,0 +1,129 @@
+/**
+ * @file Epson_PNL_CE02_Gestures.cpp
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Debounce and gesture engine for the buttons of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#include "Epson_PNL_CE02_Gestures.h"
+#include <Arduino.h>
+
+namespace
+{
+const uint16_t ALL_BUTTONS = 0x1FF; // ButtonMask bits + POWER_BUTTON_MASK
+} // namespace
+
+// CTOR
+Epson_PNL_CE02_Gestures::Epson_PNL_CE02_Gestures(uint16_t doubleClickMs, uint16_t longPressMs)
+    : doubleClickDelay(doubleClickMs), longPressDelay(longPressMs)
+{
+}
+
+// PUBLICS
+Gesture Epson_PNL_CE02_Gestures::update(uint16_t sequence)
+{
+    const uint16_t now = millis();
+
+    // STEP 1: Debounce, counters of changed buttons count down from 3, stable buttons are reset to 3
+    uint16_t changed = (state ^ sequence) & ALL_BUTTONS;
+    count0 = ~(count0 & changed);
+    count1 = count0 ^ (count1 & changed);
+    changed &= count0 & count1; // rolled over after 4 identical samples
+    state ^= changed;
+    toggled = changed;
+
+    // STEP 2: Gestures of the chord
+    const uint16_t pressedNow = state & changed;
+    if (pressedNow != 0 && chord == 0)
+    {
+        chordStart = now;
+        longPressed = false;
+        chord = pressedNow;
+        if (pending != 0 && static_cast<uint16_t>(now - pendingRelease) > doubleClickDelay)
+        {
+            return flushClick();
+        }
+        return Gesture::NONE;
+    }
+    chord |= pressedNow;
+
+    if (chord != 0 && state != 0)
+    {
+        if (!longPressed && static_cast<uint16_t>(now - chordStart) >= longPressDelay)
+        {
+            if (pending != 0)
+            {
+                return flushClick(); // the long press is reported by the next update
+            }
+            longPressed = true;
+            return report(Gesture::LONG_PRESS, chord);
+        }
+        return Gesture::NONE;
+    }
+
+    if (chord != 0) // all released
+    {
+        const uint16_t released = chord;
+        chord = 0;
+        if (longPressed)
+        {
+            return Gesture::NONE;
+        }
+        if (pending == released)
+        {
+            pending = 0;
+            return report(Gesture::DOUBLE_CLICK, released);
+        }
+        const Gesture previous = pending != 0 ? flushClick() : Gesture::NONE;
+        pending = released;
+        pendingRelease = now;
+        return previous;
+    }
+
+    if (pending != 0 && static_cast<uint16_t>(now - pendingRelease) > doubleClickDelay)
+    {
+        return flushClick();
+    }
+    return Gesture::NONE;
+}
+
+// cppcheck-suppress unusedFunction
+uint16_t Epson_PNL_CE02_Gestures::buttons() const
+{
+    return gestureButtons;
+}
+
+// cppcheck-suppress unusedFunction
+uint16_t Epson_PNL_CE02_Gestures::pressed() const
+{
+    return state;
+}
+
+// cppcheck-suppress unusedFunction
+uint16_t Epson_PNL_CE02_Gestures::justPressed() const
+{
+    return state & toggled;
+}
+
+// cppcheck-suppress unusedFunction
+uint16_t Epson_PNL_CE02_Gestures::justReleased() const
+{
+    return ~state & toggled;
+}
+
+// PRIVATES
+Gesture Epson_PNL_CE02_Gestures::report(Gesture gesture, uint16_t buttons)
+{
+    gestureButtons = buttons;
+    return gesture;
+}
+
+Gesture Epson_PNL_CE02_Gestures::flushClick()
+{
+    const uint16_t buttons = pending;
+    pending = 0;
+    return report(Gesture::CLICK, buttons);
+}
@@ -0,0 +1,120 @@
+/**
+ * @file Epson_PNL_CE02_Gestures.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Debounce and gesture engine for the buttons of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * The 8 buttons and the power button are processed together, one bit each:
+ *  => debounce: 2-bit vertical counters, a button changes after 4 identical samples
+ *  => gestures: buttons pressed together form a chord, a single button is a chord of one. Click, double click and
+ *     long press are reported for the whole chord.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_GESTURES_H
+#define EPSON_PNL_CE02_GESTURES_H
+
+#include <Arduino.h>
+#include <Epson_PNL_CE02.h>
+
+/**
+ * @brief Gestures reported by Epson_PNL_CE02_Gestures::update().
+ */
+enum class Gesture : byte // NOLINT(readability-identifier-naming): Bug clangtidy v15: enum detected as variable
+{
+    NONE,
+    CLICK,        // released before the long press delay, without a second click in the double click delay
+    DOUBLE_CLICK, // two clicks of the same buttons
+    LONG_PRESS,   // held for the long press delay, reported once while held
+};
+
+/**
+ * @brief Debounce and gesture engine of the 9 buttons, from a single update() call per scan.
+ *
+ * @example
+ * ``` c++
+ * Epson_PNL_CE02_Gestures gestures;
+ *
+ * void loop() {
+ *     const uint16_t sequence = controlPanel.readButtons() |
+ *                               (controlPanel.isPowerButtonPressed() ? POWER_BUTTON_MASK : 0);
+ *     if (gestures.update(sequence) == Gesture::CLICK &&
+ *         gestures.buttons() == (static_cast<byte>(ButtonMask::HOME) | static_cast<byte>(ButtonMask::OK))) {
+ *         Serial.println("HOME + OK clicked");
+ *     }
+ *     delay(5);
+ * }
+ * ```
+ */
+class Epson_PNL_CE02_Gestures // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    /**
+     * @brief Construct a new Epson_PNL_CE02_Gestures object
+     *
+     * @param doubleClickMs maximum delay between the release of a click and the press of the second click
+     * @param longPressMs minimum delay to hold buttons for a long press
+     */
+    explicit Epson_PNL_CE02_Gestures(uint16_t doubleClickMs = 300, uint16_t longPressMs = 800);
+
+    /**
+     * @brief Process a buttons sample, to call at a steady rate (5 to 10 ms).
+     *
+     * @param sequence pressed buttons in 9-bit sequence (refer to ButtonMask and POWER_BUTTON_MASK)
+     * @return Gesture detected by this sample, refer to buttons()
+     */
+    Gesture update(uint16_t sequence);
+
+    /**
+     * @brief Buttons of the last gesture, one bit for a single button, several bits for a chord.
+     *
+     * @return uint16_t 9-bit sequence
+     */
+    uint16_t buttons() const;
+
+    /**
+     * @brief Debounced pressed buttons.
+     *
+     * @return uint16_t 9-bit sequence
+     */
+    uint16_t pressed() const;
+
+    /**
+     * @brief Buttons pressed by the last update().
+     *
+     * @return uint16_t 9-bit sequence
+     */
+    uint16_t justPressed() const;
+
+    /**
+     * @brief Buttons released by the last update().
+     *
+     * @return uint16_t 9-bit sequence
+     */
+    uint16_t justReleased() const;
+
+  private:
+    uint16_t doubleClickDelay;
+    uint16_t longPressDelay;
+
+    // Vertical counters, bit i of count0 / count1 form the 2-bit counter of button i
+    uint16_t count0{0xFFFF};
+    uint16_t count1{0xFFFF};
+    uint16_t state{0};
+    uint16_t toggled{0}; // buttons changed by the last update()
+
+    uint16_t chord{0};          // buttons pressed since the first press
+    uint16_t chordStart{0};     // millis() of the first press, 16-bit
+    bool longPressed{false};    // LONG_PRESS reported for `chord`
+    uint16_t pending{0};        // click waiting for a second click
+    uint16_t pendingRelease{0}; // millis() of the pending click release, 16-bit
+    uint16_t gestureButtons{0};
+
+    Gesture report(Gesture gesture, uint16_t buttons);
+    Gesture flushClick();
+};
+
+#endif // EPSON_PNL_CE02_GESTURES_H
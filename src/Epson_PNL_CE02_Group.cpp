@@ -0,0 +1,138 @@
+/**
+ * @file Epson_PNL_CE02_Group.cpp
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Several control panels (PNL CE02) of EPSON XP 520/530/540 printers on one SPI bus.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#include "Epson_PNL_CE02_Group.h"
+#include <Arduino.h>
+
+// CTOR
+Epson_PNL_CE02_Group::Epson_PNL_CE02_Group(Epson_PNL_CE02 *const *pPanels, byte count, ButtonWiring wiring)
+    : panels(pPanels), panelCount(count < MAX_PANELS ? count : MAX_PANELS), buttonWiring(wiring)
+{
+}
+
+// PUBLICS
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Group::begin() const
+{
+    for (byte index = 0; index < panelCount; index++)
+    {
+        panels[index]->begin();
+    }
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Group::setInputSelector(void (*pSelect)(byte panel))
+{
+    selectInput = pSelect;
+}
+
+// cppcheck-suppress unusedFunction
+uint16_t Epson_PNL_CE02_Group::scan()
+{
+    byte previous[MAX_PANELS];
+    for (byte index = 0; index < panelCount; index++)
+    {
+        previous[index] = panels[index]->buttons;
+    }
+
+    {
+        // A bus handler would clock the loaded registers out
+        const Epson_PNL_CE02::BusOwner owner;
+        if (buttonWiring == ButtonWiring::CHAINED)
+        {
+            scanChained();
+        }
+        else
+        {
+            scanMultiplexed();
+        }
+    }
+
+    uint16_t changed = 0;
+    for (byte index = 0; index < panelCount; index++)
+    {
+        if (panels[index]->buttons != previous[index])
+        {
+            bitSet(changed, index);
+        }
+    }
+    return changed;
+}
+
+// cppcheck-suppress unusedFunction
+byte Epson_PNL_CE02_Group::buttons(byte panel) const
+{
+    return panel < panelCount ? panels[panel]->buttons : 0;
+}
+
+// cppcheck-suppress unusedFunction
+byte Epson_PNL_CE02_Group::count() const
+{
+    return panelCount;
+}
+
+// cppcheck-suppress unusedFunction
+Epson_PNL_CE02 &Epson_PNL_CE02_Group::panel(byte index) const
+{
+    return *panels[index];
+}
+
+// PRIVATES
+void Epson_PNL_CE02_Group::scanChained()
+{
+    // A LATCH pulse latches the 74HC595 shift register content: panels expecting the same extender value are loaded
+    // back to back, then the whole chain is read. Usually all panels share a single pass.
+    uint16_t pending = (1UL << panelCount) - 1;
+    while (pending != 0)
+    {
+        byte first = 0;
+        while (!bitRead(pending, first))
+        {
+            first++;
+        }
+        const byte output = panels[first]->scanOutput();
+
+        uint16_t loaded = 0;
+        for (byte index = first; index < panelCount; index++)
+        {
+            if (bitRead(pending, index) && panels[index]->scanOutput() == output)
+            {
+                panels[index]->latch(output); // shifted once, then only LATCH is pulsed
+                bitSet(loaded, index);
+            }
+        }
+        pending &= ~loaded;
+
+        // The first panel drives SERIAL_OUT, bytes of the other panels follow through the chain
+        for (byte index = 0; index < panelCount; index++)
+        {
+            const byte value = Epson_PNL_CE02::shiftIn(output); // keeps `output` in the 74HC595 shift registers
+            if (bitRead(loaded, index))
+            {
+                panels[index]->buttons = value;
+            }
+        }
+    }
+}
+
+void Epson_PNL_CE02_Group::scanMultiplexed()
+{
+    for (byte index = 0; index < panelCount; index++)
+    {
+        Epson_PNL_CE02 *pPanel = panels[index];
+        if (selectInput != nullptr)
+        {
+            selectInput(index);
+        }
+        const byte output = pPanel->scanOutput();
+        pPanel->latch(output); // not shifted again when the previous panel had the same extender value
+        pPanel->buttons = Epson_PNL_CE02::shiftIn(output);
+    }
+}
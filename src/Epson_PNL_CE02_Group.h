@@ -0,0 +1,117 @@
+/**
+ * @file Epson_PNL_CE02_Group.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Several control panels (PNL CE02) of EPSON XP 520/530/540 printers on one SPI bus.
+ *
+ * Panels share CLOCK, SERIAL_IN and SERIAL_OUT, each panel keeps its own LATCH and LCD_WRITE pins:
+ *  => every 74HC595 and 74HC164 receives every byte, only the panel whose LATCH (extender) or LCD_WRITE (display) is
+ *     pulsed takes it: give each panel its own Epson_PNL_CE02_Display to route display writes
+ *  => LATCH also loads the 74LV165A buttons register of its panel, buttons of all panels are read in a single bus
+ *     transaction by Epson_PNL_CE02_Group::scan()
+ *
+ * The 74LV165A outputs cannot drive SERIAL_OUT together, wire them as follows (refer to ButtonWiring):
+ *  => CHAINED: the first panel drives SERIAL_OUT, the serial input (DS, tied HIGH on the board) of each 74LV165A is
+ *     wired to the SERIAL_OUT of the next panel. LATCH pulses load the registers back to back, then a single burst
+ *     reads a byte per panel.
+ *  => MULTIPLEXED: a selector (e.g. a 74HC151 multiplexer or 74HC125 buffers) routes the SERIAL_OUT of one panel
+ *     at a time, driven by a function of the sketch.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_GROUP_H
+#define EPSON_PNL_CE02_GROUP_H
+
+#include <Arduino.h>
+#include <Epson_PNL_CE02.h>
+
+/**
+ * @brief Wiring of the SERIAL_OUT lines of a group of panels.
+ */
+enum class ButtonWiring : byte // NOLINT(readability-identifier-naming): Bug clangtidy v15: enum detected as variable
+{
+    CHAINED,
+    MULTIPLEXED,
+};
+
+/**
+ * @brief Panels sharing the SPI bus, scanned together.
+ *
+ * @example
+ * ``` c++
+ * Epson_PNL_CE02 left(&leftPinout);   // LATCH 48, LCD_WRITE 49
+ * Epson_PNL_CE02 right(&rightPinout); // LATCH 44, LCD_WRITE 43, same CLOCK / SERIAL_IN / SERIAL_OUT
+ * Epson_PNL_CE02 *const PANELS[] = {&left, &right};
+ * Epson_PNL_CE02_Group group(PANELS, 2);
+ * Epson_PNL_CE02_Display leftDisplay(&left);
+ * Epson_PNL_CE02_Display rightDisplay(&right);
+ *
+ * const uint16_t changed = group.scan();
+ * if (bitRead(changed, 1) && isButtonPressed(group.buttons(1), ButtonMask::OK)) {
+ *     rightDisplay.fillRect(0, 0, 128, 128, 0x07E0);
+ * }
+ * ```
+ */
+class Epson_PNL_CE02_Group // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    static const byte MAX_PANELS = 16; // bits of the mask returned by scan()
+
+    /**
+     * @brief Construct a new Epson_PNL_CE02_Group object.
+     *
+     * @param pPanels panels, the table is kept. CHAINED: the first panel drives SERIAL_OUT.
+     * @param count number of panels, up to MAX_PANELS
+     * @param wiring wiring of the SERIAL_OUT lines
+     */
+    Epson_PNL_CE02_Group(Epson_PNL_CE02 *const *pPanels, byte count, ButtonWiring wiring = ButtonWiring::CHAINED);
+
+    /**
+     * @brief Set pins directions of every panel and initialize SPI bus.
+     */
+    void begin() const;
+
+    /**
+     * @brief Set the function routing the SERIAL_OUT of a panel to the SPI MISO pin (MULTIPLEXED wiring).
+     *
+     * @param pSelect called with the index of the panel before its buttons are read
+     */
+    void setInputSelector(void (*pSelect)(byte panel));
+
+    /**
+     * @brief Read the buttons of every panel in a single bus transaction, pending extender changes are latched.
+     * CHAINED: a byte per panel and per distinct extender value, MULTIPLEXED: one or two bytes per panel.
+     *
+     * @return uint16_t bit mask of the panels whose buttons changed
+     */
+    uint16_t scan();
+
+    /**
+     * @brief Buttons of a panel read by the last scan(), refer to ButtonMask.
+     */
+    byte buttons(byte panel) const;
+
+    /**
+     * @brief Number of panels.
+     */
+    byte count() const;
+
+    /**
+     * @brief A panel of the group, e.g. to drive its extender.
+     */
+    Epson_PNL_CE02 &panel(byte index) const;
+
+  private:
+    Epson_PNL_CE02 *const *panels;
+    byte panelCount;
+    ButtonWiring buttonWiring;
+    void (*selectInput)(byte panel) = nullptr;
+
+    void scanChained();
+    void scanMultiplexed();
+};
+
+#endif // EPSON_PNL_CE02_GROUP_H
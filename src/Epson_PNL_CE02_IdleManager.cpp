@@ -0,0 +1,192 @@
+/**
+ * @file Epson_PNL_CE02_IdleManager.cpp
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Adaptive scan rate and idle low-power mode of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#include "Epson_PNL_CE02_IdleManager.h"
+#include <Arduino.h>
+
+#if defined(ARDUINO_ARCH_AVR) && defined(WDTCSR)
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#define EPSON_PNL_CE02_IDLE_SLEEP
+#endif
+
+namespace
+{
+const byte LIGHTS = extenderMask(ExtenderPin::LCD_BACKLIGHT) | extenderMask(ExtenderPin::POWER_LED);
+const byte LIGHTS_OFF = extenderMask(ExtenderPin::POWER_LED); // active LOW
+bool watchdogAttached = false;  // WDT_vect defined in the sketch, refer to EPSON_PNL_CE02_IDLE_MANAGER_ISR()
+bool pinChangeAttached = false; // PCINTn_vect defined in the sketch
+
+#if defined(EPSON_PNL_CE02_IDLE_SLEEP)
+const uint16_t WATCHDOG_MIN_MS = 16;
+const byte WATCHDOG_MAX_PRESCALER = 9; // 8 s
+
+/**
+ * @brief WDTCSR prescaler bits of the longest watchdog period up to `ms`.
+ */
+byte watchdogPrescaler(uint16_t ms)
+{
+    byte prescaler = 0;
+    while (prescaler < WATCHDOG_MAX_PRESCALER && (static_cast<uint32_t>(WATCHDOG_MIN_MS) << (prescaler + 1)) <= ms)
+    {
+        prescaler++;
+    }
+    return (prescaler & 0x07) | ((prescaler & 0x08) != 0 ? _BV(WDP3) : 0);
+}
+#endif
+} // namespace
+
+// CTOR
+Epson_PNL_CE02_IdleManager::Epson_PNL_CE02_IdleManager(Epson_PNL_CE02 *pControlPanel, uint32_t timeoutMs,
+                                                       uint16_t scanMs, uint16_t idleScanMs)
+    : controlPanel(pControlPanel), timeout(timeoutMs), scanInterval(scanMs), idleScanInterval(idleScanMs)
+{
+}
+
+// PUBLICS
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_IdleManager::begin()
+{
+    idle = false;
+    lastInput = millis();
+    lastScan = lastInput - scanInterval; // first scan at once
+}
+
+// cppcheck-suppress unusedFunction
+uint16_t Epson_PNL_CE02_IdleManager::scan()
+{
+    if (idle)
+    {
+        sleepIdle();
+    }
+    else
+    {
+        waitActive();
+    }
+
+    const uint16_t sequence =
+        controlPanel->scanButtons() | (controlPanel->isPowerButtonPressed() ? POWER_BUTTON_MASK : 0);
+    lastScan = millis();
+    if (sequence != 0)
+    {
+        if (idle)
+        {
+            wake(); // the next scan is at the full rate
+        }
+        lastInput = lastScan;
+    }
+    else if (!idle && lastScan - lastInput >= timeout)
+    {
+        enterIdle();
+    }
+    return sequence;
+}
+
+void Epson_PNL_CE02_IdleManager::wake()
+{
+    lastInput = millis();
+    if (!idle)
+    {
+        return;
+    }
+    idle = false;
+    controlPanel->extenderWriteMask(LIGHTS, lights);
+}
+
+// cppcheck-suppress unusedFunction
+bool Epson_PNL_CE02_IdleManager::attachWakeInterrupts(bool pinChange)
+{
+    watchdogAttached = true;
+    pinChangeAttached = pinChange;
+    return true;
+}
+
+// cppcheck-suppress unusedFunction
+bool Epson_PNL_CE02_IdleManager::isIdle() const
+{
+    return idle;
+}
+
+// PRIVATES
+void Epson_PNL_CE02_IdleManager::enterIdle()
+{
+    idle = true;
+    lights = controlPanel->buffer & LIGHTS;
+    controlPanel->extenderWriteMask(LIGHTS, LIGHTS_OFF);
+}
+
+void Epson_PNL_CE02_IdleManager::waitActive() const
+{
+    const unsigned long elapsed = millis() - lastScan;
+    if (elapsed >= scanInterval)
+    {
+        return;
+    }
+#if defined(EPSON_PNL_CE02_IDLE_SLEEP)
+    // Woken by every millis() tick
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    while (millis() - lastScan < scanInterval)
+    {
+        sleep_mode();
+    }
+#else
+    delay(scanInterval - elapsed);
+#endif
+}
+
+void Epson_PNL_CE02_IdleManager::sleepIdle() const
+{
+#if defined(EPSON_PNL_CE02_IDLE_SLEEP)
+    if (!watchdogAttached)
+    {
+        delay(idleScanInterval); // nothing would wake the MCU from power-down
+        return;
+    }
+
+    const byte adc = ADCSRA;
+    ADCSRA = adc & ~_BV(ADEN); // the ADC draws current even in power-down
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+
+    noInterrupts();
+    wdt_reset();
+    WDTCSR = _BV(WDCE) | _BV(WDE);
+    WDTCSR = _BV(WDIE) | watchdogPrescaler(idleScanInterval); // interrupt only, no reset
+
+    const byte pin = controlPanel->pins->POWER_BUTTON;
+    volatile uint8_t *pControl = pinChangeAttached ? digitalPinToPCICR(pin) : nullptr;
+    volatile uint8_t *pMask = pinChangeAttached ? digitalPinToPCMSK(pin) : nullptr;
+    byte mask = 0;
+    byte control = 0;
+    if (pControl != nullptr && pMask != nullptr)
+    {
+        mask = *pMask;
+        control = *pControl;
+        *pMask = mask | _BV(digitalPinToPCMSKbit(pin));
+        PCIFR = _BV(digitalPinToPCICRbit(pin)); // forget older changes
+        *pControl = control | _BV(digitalPinToPCICRbit(pin));
+    }
+
+    // A change between interrupts() and sleep_cpu() is served after sleep_cpu(), waking the MCU at once
+    sleep_enable();
+    interrupts();
+    sleep_cpu();
+    sleep_disable();
+
+    if (pControl != nullptr && pMask != nullptr)
+    {
+        *pControl = control;
+        *pMask = mask;
+    }
+    wdt_disable();
+    ADCSRA = adc;
+#else
+    delay(idleScanInterval);
+#endif
+}
@@ -0,0 +1,177 @@
+/**
+ * @file Epson_PNL_CE02_IdleManager.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Adaptive scan rate and idle low-power mode of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * The MCU sleeps between two button scans instead of spinning in loop():
+ *  => active: buttons are scanned every `scanMs`, the MCU sleeps in idle mode between scans (timers keep running)
+ *  => idle, after `timeoutMs` without any pressed button: the backlight and the power led are turned off in a single
+ *     latch cycle, buttons are scanned every `idleScanMs` only, the MCU sleeps in power-down mode between scans, woken
+ *     by the watchdog or at once by the power button
+ *  => the first scan seeing a pressed button restores the lights and the full scan rate, the pressed buttons are
+ *     returned by this scan: the key press is not swallowed by the wake up
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_IDLE_MANAGER_H
+#define EPSON_PNL_CE02_IDLE_MANAGER_H
+
+#include <Arduino.h>
+#include <Epson_PNL_CE02.h>
+
+/**
+ * @brief Paces the button scans of loop() and puts the MCU to sleep while the panel is not used.
+ *
+ * On AVR, the idle mode sleeps in power-down once the sketch defines the wake up interrupts, with
+ * EPSON_PNL_CE02_IDLE_MANAGER_ISR() (watchdog and pin changes) or EPSON_PNL_CE02_IDLE_MANAGER_WATCHDOG_ISR() (watchdog
+ * only, the pin change vectors are left to another library, e.g. SoftwareSerial). Without them, the idle mode only
+ * slows the scans down and waits with delay().
+ * Power-down stops the millis() timer, millis() does not count while idle. The 8 buttons are read through the
+ * 74LV165A and can only be seen by a scan; the power button wakes the MCU at once when its pin has a pin change
+ * interrupt (e.g. A8 to A15 or 10 to 13 on MEGA 2560), otherwise it is read by the scans too.
+ * Flush serial output before scan() (e.g. `Serial.flush()`), the UART stops while idle.
+ * On other architectures, the MCU waits with delay() instead of sleeping.
+ *
+ * @example
+ * ``` c++
+ * Epson_PNL_CE02_IdleManager idle(&controlPanel, 30000); // idle after 30 s
+ * EPSON_PNL_CE02_IDLE_MANAGER_ISR();                       // once in the sketch
+ *
+ * void setup() {
+ *     controlPanel.begin();
+ *     idle.begin();
+ * }
+ *
+ * void loop() {
+ *     const uint16_t buttons = idle.scan(); // sleeps until the next scan
+ *     if (isButtonPressed(buttons, ButtonMask::OK)) {
+ *         Serial.println("OK pressed");
+ *     }
+ * }
+ * ```
+ */
+class Epson_PNL_CE02_IdleManager // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    /**
+     * @brief Construct a new Epson_PNL_CE02_IdleManager object.
+     *
+     * @param pControlPanel Reference to the control panel, buttons and lights.
+     * @param timeoutMs milliseconds without any pressed button before the idle mode
+     * @param scanMs milliseconds between two scans when active
+     * @param idleScanMs milliseconds between two scans when idle, rounded down to the watchdog periods on AVR (16 ms
+     * to 8 s, powers of two)
+     */
+    Epson_PNL_CE02_IdleManager(Epson_PNL_CE02 *pControlPanel, uint32_t timeoutMs = 30000, uint16_t scanMs = 10,
+                               uint16_t idleScanMs = 250);
+
+    /**
+     * @brief Start active, the idle timeout counts from now. Epson_PNL_CE02::begin() must be called before.
+     */
+    void begin();
+
+    /**
+     * @brief Sleep until the next scan is due, scan the buttons and update the idle mode.
+     *
+     * @return uint16_t pressed buttons in 9-bit sequence (refer to ButtonMask and POWER_BUTTON_MASK)
+     */
+    uint16_t scan();
+
+    /**
+     * @brief Leave the idle mode: lights restored, full scan rate, the idle timeout counts from now.
+     * Call it on activity not seen by scan(), e.g. data received.
+     */
+    void wake();
+
+    /**
+     * @brief Determine if the panel is idle: lights off, slow scans.
+     *
+     * @return true
+     * @return false
+     */
+    bool isIdle() const;
+
+    /**
+     * @brief Let the idle mode sleep in power-down. Called by EPSON_PNL_CE02_IDLE_MANAGER_ISR() and
+     * EPSON_PNL_CE02_IDLE_MANAGER_WATCHDOG_ISR().
+     *
+     * @param pinChange true if the pin change vectors are defined: the power button wakes the MCU at once
+     * @return true
+     */
+    static bool attachWakeInterrupts(bool pinChange);
+
+  private:
+    Epson_PNL_CE02 *controlPanel;
+    uint32_t timeout;
+    uint16_t scanInterval;
+    uint16_t idleScanInterval;
+    unsigned long lastScan = 0;
+    unsigned long lastInput = 0;
+    byte lights = 0; // LCD_BACKLIGHT and POWER_LED before the idle mode
+    bool idle = false;
+
+    /**
+     * @brief Turn the lights off, slow scans.
+     */
+    void enterIdle();
+
+    /**
+     * @brief Wait for the next scan when active.
+     */
+    void waitActive() const;
+
+    /**
+     * @brief Sleep until the watchdog or the power button wakes the MCU.
+     */
+    void sleepIdle() const;
+};
+
+/**
+ * @brief Define the interrupts waking the MCU from the idle mode, once in the sketch (AVR). They only wake the MCU.
+ * The library does not define them: sketches not using the idle manager keep the vectors for other code.
+ */
+#if defined(ARDUINO_ARCH_AVR) && defined(WDT_vect)
+#if defined(PCINT0_vect)
+#define EPSON_PNL_CE02_IDLE_PCINT0_ISR EMPTY_INTERRUPT(PCINT0_vect)
+#else
+#define EPSON_PNL_CE02_IDLE_PCINT0_ISR
+#endif
+#if defined(PCINT1_vect)
+#define EPSON_PNL_CE02_IDLE_PCINT1_ISR EMPTY_INTERRUPT(PCINT1_vect)
+#else
+#define EPSON_PNL_CE02_IDLE_PCINT1_ISR
+#endif
+#if defined(PCINT2_vect)
+#define EPSON_PNL_CE02_IDLE_PCINT2_ISR EMPTY_INTERRUPT(PCINT2_vect)
+#else
+#define EPSON_PNL_CE02_IDLE_PCINT2_ISR
+#endif
+#if defined(PCINT3_vect)
+#define EPSON_PNL_CE02_IDLE_PCINT3_ISR EMPTY_INTERRUPT(PCINT3_vect)
+#else
+#define EPSON_PNL_CE02_IDLE_PCINT3_ISR
+#endif
+
+// Watchdog and pin changes: the power button wakes the MCU at once
+#define EPSON_PNL_CE02_IDLE_MANAGER_ISR()                                                                              \
+    EMPTY_INTERRUPT(WDT_vect)                                                                                          \
+    EPSON_PNL_CE02_IDLE_PCINT0_ISR                                                                                     \
+    EPSON_PNL_CE02_IDLE_PCINT1_ISR                                                                                     \
+    EPSON_PNL_CE02_IDLE_PCINT2_ISR                                                                                     \
+    EPSON_PNL_CE02_IDLE_PCINT3_ISR                                                                                     \
+    static const bool EPSON_PNL_CE02_IDLE_MANAGER_ATTACHED = Epson_PNL_CE02_IdleManager::attachWakeInterrupts(true)
+
+// Watchdog only: the power button is read by the scans
+#define EPSON_PNL_CE02_IDLE_MANAGER_WATCHDOG_ISR()                                                                     \
+    EMPTY_INTERRUPT(WDT_vect)                                                                                          \
+    static const bool EPSON_PNL_CE02_IDLE_MANAGER_ATTACHED = Epson_PNL_CE02_IdleManager::attachWakeInterrupts(false)
+#else
+#define EPSON_PNL_CE02_IDLE_MANAGER_ISR() static_assert(true, "the MCU waits with delay()")
+#define EPSON_PNL_CE02_IDLE_MANAGER_WATCHDOG_ISR() static_assert(true, "the MCU waits with delay()")
+#endif
+
+#endif // EPSON_PNL_CE02_IDLE_MANAGER_H
@@ -0,0 +1,110 @@
+/**
+ * @file Epson_PNL_CE02_Image.cpp
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Compressed PROGMEM images of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#include "Epson_PNL_CE02_Image.h"
+#include <Arduino.h>
+
+namespace
+{
+const byte HEADER_SIZE = 4;
+const byte RUN_BIT = 0x80;
+const byte LONG_RUN_BIT = 0x40;
+const byte LITERAL_LENGTH = 0x7F;
+const byte RUN_LENGTH = 0x3F;
+} // namespace
+
+// CTOR
+Epson_PNL_CE02_Image::Epson_PNL_CE02_Image(const byte *pImage) : image(pImage)
+{
+    next = palette() + 2 * colors();
+    remaining = isValid() ? static_cast<uint32_t>(width()) * height() : 0;
+}
+
+// PUBLICS
+bool Epson_PNL_CE02_Image::isValid() const
+{
+    return pgm_read_byte(image) == FORMAT && width() > 0 && height() > 0;
+}
+
+byte Epson_PNL_CE02_Image::width() const
+{
+    return pgm_read_byte(image + 1);
+}
+
+byte Epson_PNL_CE02_Image::height() const
+{
+    return pgm_read_byte(image + 2);
+}
+
+uint16_t Epson_PNL_CE02_Image::colors() const
+{
+    return pgm_read_byte(image + 3) + 1;
+}
+
+const byte *Epson_PNL_CE02_Image::palette() const
+{
+    return image + HEADER_SIZE;
+}
+
+// cppcheck-suppress unusedFunction
+uint16_t Epson_PNL_CE02_Image::color(byte index) const
+{
+    const byte *pColor = palette() + 2 * index;
+    return pgm_read_byte(pColor) << 8 | pgm_read_byte(pColor + 1);
+}
+
+byte Epson_PNL_CE02_Image::bitsPerIndex() const
+{
+    const uint16_t count = colors();
+    if (count <= 2)
+    {
+        return 1;
+    }
+    if (count <= 4)
+    {
+        return 2;
+    }
+    return count <= 16 ? 4 : 8;
+}
+
+bool Epson_PNL_CE02_Image::nextPacket(Packet &packet)
+{
+    if (remaining == 0)
+    {
+        return false;
+    }
+
+    const byte header = pgm_read_byte(next++);
+    packet.run = (header & RUN_BIT) != 0;
+    if (!packet.run)
+    {
+        packet.length = (header & LITERAL_LENGTH) + 1;
+        packet.pIndexes = next;
+        next += (static_cast<uint16_t>(packet.length) * bitsPerIndex() + 7) / 8;
+    }
+    else
+    {
+        packet.length = header & RUN_LENGTH;
+        if ((header & LONG_RUN_BIT) != 0)
+        {
+            packet.length = packet.length << 8 | pgm_read_byte(next++);
+        }
+        packet.length++;
+        packet.index = pgm_read_byte(next++);
+    }
+
+    // A corrupted image never draws out of its window
+    if (packet.length > remaining)
+    {
+        packet.length = remaining;
+    }
+    remaining -= packet.length;
+    return true;
+}
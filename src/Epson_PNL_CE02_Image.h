@@ -0,0 +1,118 @@
+/**
+ * @file Epson_PNL_CE02_Image.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Compressed PROGMEM images of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * Images are palette-indexed and run-length encoded, generated from PNG files by extras/image_converter.
+ * Format, all in PROGMEM:
+ *
+ * | Offset | Size          | Content                                                   |
+ * |--------|---------------|-----------------------------------------------------------|
+ * | 0      | 1             | FORMAT (0xCE)                                             |
+ * | 1      | 1             | width, 1 to 128                                           |
+ * | 2      | 1             | height, 1 to 128                                          |
+ * | 3      | 1             | colors - 1                                                |
+ * | 4      | 2 x colors    | palette, RGB565 high byte first                           |
+ * | ...    | ...           | packets, until width x height pixels, row by row          |
+ *
+ * Packets:
+ *  => `0LLLLLLL` + indexes: L + 1 literal pixels (1 to 128), indexes of 1, 2, 4 or 8 bits (2, 4, 16 or 256 colors)
+ *     packed most significant bits first, the packet ends on a byte boundary
+ *  => `10LLLLLL` + index: run of L + 1 pixels (1 to 64)
+ *  => `11LLLLLL LLLLLLLL` + index: run of L + 1 pixels (1 to 16384), length high bits first
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_IMAGE_H
+#define EPSON_PNL_CE02_IMAGE_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Reader of a compressed image stored in flash memory (PROGMEM), packet by packet.
+ *
+ * @example
+ * ``` c++
+ * #include "splash.h" // generated by extras/image_converter
+ *
+ * display.drawImage_P(0, 0, SPLASH);
+ * ```
+ */
+class Epson_PNL_CE02_Image // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    static const byte FORMAT = 0xCE;
+
+    /**
+     * @brief Pixels of the same color, or literal pixels.
+     */
+    struct Packet
+    {
+        bool run;
+        uint16_t length;      // pixels
+        byte index;           // run color
+        const byte *pIndexes; // literal indexes in PROGMEM, refer to bitsPerIndex()
+    };
+
+    /**
+     * @brief Construct a new Epson_PNL_CE02_Image object, positioned on the first packet.
+     *
+     * @param pImage image in PROGMEM
+     */
+    explicit Epson_PNL_CE02_Image(const byte *pImage);
+
+    /**
+     * @brief Determine if the image starts with FORMAT and has a size.
+     *
+     * @return true
+     * @return false
+     */
+    bool isValid() const;
+
+    byte width() const;
+    byte height() const;
+
+    /**
+     * @brief Number of palette colors, 1 to 256.
+     */
+    uint16_t colors() const;
+
+    /**
+     * @brief Palette in PROGMEM, RGB565 high byte first.
+     */
+    const byte *palette() const;
+
+    /**
+     * @brief Get a palette color.
+     *
+     * @param index palette index
+     * @return uint16_t RGB565 color
+     */
+    uint16_t color(byte index) const;
+
+    /**
+     * @brief Size of literal indexes, depending on the number of colors.
+     *
+     * @return byte 1, 2, 4 or 8 bits
+     */
+    byte bitsPerIndex() const;
+
+    /**
+     * @brief Read the next packet.
+     *
+     * @param packet receives the packet
+     * @return true if a packet was read, false at the end of the image
+     */
+    bool nextPacket(Packet &packet);
+
+  private:
+    const byte *image;
+    const byte *next;   // next packet
+    uint32_t remaining; // pixels left to read
+};
+
+#endif // EPSON_PNL_CE02_IMAGE_H
@@ -0,0 +1,387 @@
+/**
+ * @file Epson_PNL_CE02_Remote.cpp
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Host-driven display over a serial link, for the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#include "Epson_PNL_CE02_Remote.h"
+#include <Arduino.h>
+
+#if defined(ARDUINO_ARCH_AVR)
+#include <util/crc16.h>
+#endif
+
+namespace
+{
+const byte VERSION = 1;
+const byte SYNC_BYTE = 0xA5;
+
+// Host to panel
+const byte PING = 0x01;
+const byte FILL = 0x10;
+const byte RECT = 0x11;
+const byte EXTENDER = 0x20;
+
+// Panel to host
+const byte INFO = 0x81;
+const byte CREDIT = 0x82;
+const byte BUTTONS = 0x83;
+const byte ERROR = 0x84;
+
+// ERROR codes
+const byte ERROR_CRC = 1;
+const byte ERROR_COMMAND = 2;
+const byte ERROR_PAYLOAD = 3;
+
+const byte RUN_TOKEN = 0x80;
+const uint16_t RUN_MIN = 8; // shorter runs are buffered with the literal pixels
+const uint16_t CREDIT_STEP = Epson_PNL_CE02_Remote::WINDOW / 4 > 0 ? Epson_PNL_CE02_Remote::WINDOW / 4 : 1;
+const int16_t WIDTH = Epson_PNL_CE02_Display::WIDTH;
+const int16_t HEIGHT = Epson_PNL_CE02_Display::HEIGHT;
+
+/**
+ * @brief CRC-8, polynomial 0x07, initial value 0.
+ */
+byte crc8(byte crc, byte value)
+{
+#if defined(ARDUINO_ARCH_AVR)
+    return _crc8_ccitt_update(crc, value);
+#else
+    crc ^= value;
+    for (byte bit = 0; bit < 8; bit++)
+    {
+        crc = (crc & 0x80) != 0 ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+    return crc;
+#endif
+}
+
+/**
+ * @brief Fixed part of the payload of a command.
+ *
+ * @return int16_t bytes, -1 for an unknown command
+ */
+int16_t headerSize(byte command)
+{
+    switch (command)
+    {
+    case PING:
+        return 0;
+    case FILL:
+        return 6;
+    case RECT:
+        return 4;
+    case EXTENDER:
+        return 2;
+    default:
+        return -1;
+    }
+}
+
+/**
+ * @brief Determine if the payload length suits a command. RECT tokens take 3 bytes per pixel at worst.
+ */
+bool isLengthValid(byte command, uint16_t length)
+{
+    const int16_t size = headerSize(command);
+    if (command == RECT)
+    {
+        return length >= size && length <= size + 3UL * WIDTH * HEIGHT;
+    }
+    return length == size;
+}
+} // namespace
+
+// CTOR
+Epson_PNL_CE02_Remote::Epson_PNL_CE02_Remote(Epson_PNL_CE02 *pControlPanel, Epson_PNL_CE02_Display *pDisplay,
+                                             Stream *pStream)
+    : controlPanel(pControlPanel), display(pDisplay), stream(pStream)
+{
+}
+
+// PUBLICS
+void Epson_PNL_CE02_Remote::begin(uint16_t scanInterval)
+{
+    this->scanInterval = scanInterval;
+    state = State::SYNC;
+    errorCount = 0;
+    received = 0;
+    const byte info[] = {VERSION, WIDTH, HEIGHT, lowByte(WINDOW), highByte(WINDOW)};
+    sendFrame(INFO, info, sizeof(info));
+    lastScan = millis();
+}
+
+void Epson_PNL_CE02_Remote::update()
+{
+    // Bytes received so far: the serial interrupt keeps receiving the next ones during the display writes
+    int count = stream->available();
+    while (count-- > 0)
+    {
+        const int value = stream->read();
+        if (value < 0)
+        {
+            break;
+        }
+        received++;
+        receive(value);
+        if (received >= CREDIT_STEP)
+        {
+            const byte credit[] = {lowByte(received), highByte(received)};
+            sendFrame(CREDIT, credit, sizeof(credit));
+            received = 0;
+        }
+    }
+
+    if (millis() - lastScan >= scanInterval)
+    {
+        lastScan = millis();
+        scanButtons();
+    }
+}
+
+// cppcheck-suppress unusedFunction
+uint16_t Epson_PNL_CE02_Remote::errors() const
+{
+    return errorCount;
+}
+
+// PRIVATES
+void Epson_PNL_CE02_Remote::receive(byte value)
+{
+    switch (state)
+    {
+    case State::SYNC:
+        if (value == SYNC_BYTE)
+        {
+            state = State::COMMAND;
+        }
+        return;
+    case State::COMMAND:
+        command = value;
+        checksum = crc8(0, value);
+        if (headerSize(command) < 0)
+        {
+            sendError(ERROR_COMMAND);
+            state = State::SYNC;
+            return;
+        }
+        state = State::LENGTH_LOW;
+        return;
+    case State::LENGTH_LOW:
+        length = value;
+        checksum = crc8(checksum, value);
+        state = State::LENGTH_HIGH;
+        return;
+    case State::LENGTH_HIGH:
+        length |= value << 8;
+        checksum = crc8(checksum, value);
+        if (!isLengthValid(command, length))
+        {
+            sendError(ERROR_PAYLOAD);
+            state = State::SYNC; // resynchronize on the next frame
+            return;
+        }
+        position = 0;
+        valid = headerSize(command) > 0 || startPayload();
+        state = length > 0 ? State::PAYLOAD : State::CHECKSUM;
+        return;
+    case State::PAYLOAD:
+        checksum = crc8(checksum, value);
+        receivePayload(value);
+        if (++position == length)
+        {
+            state = State::CHECKSUM;
+        }
+        return;
+    case State::CHECKSUM:
+        state = State::SYNC;
+        if (command == RECT && valid)
+        {
+            flushPixels();
+        }
+        if (value != checksum)
+        {
+            sendError(ERROR_CRC);
+            return;
+        }
+        endFrame();
+        return;
+    }
+}
+
+void Epson_PNL_CE02_Remote::receivePayload(byte value)
+{
+    const int16_t size = headerSize(command);
+    if (position < size)
+    {
+        header[position] = value;
+        if (position + 1 == size)
+        {
+            valid = startPayload();
+        }
+        return;
+    }
+    if (valid)
+    {
+        receivePixelByte(value);
+    }
+}
+
+void Epson_PNL_CE02_Remote::receivePixelByte(byte value)
+{
+    if (tokenLeft == 0)
+    {
+        tokenRun = (value & RUN_TOKEN) != 0;
+        tokenLeft = (value & ~RUN_TOKEN) + 1;
+        return;
+    }
+    if (!colorHigh)
+    {
+        colorLow = value;
+        colorHigh = true;
+        return;
+    }
+    colorHigh = false;
+
+    const uint16_t color = colorLow | (value << 8);
+    const uint16_t count = tokenRun ? tokenLeft : 1;
+    if (count > pixelsLeft)
+    {
+        valid = false; // more pixels than the rectangle
+        return;
+    }
+    pushPixels(color, count);
+    tokenLeft -= count;
+}
+
+void Epson_PNL_CE02_Remote::endFrame()
+{
+    switch (command)
+    {
+    case PING: {
+        received = 0; // the host restarts with a whole window
+        const byte info[] = {VERSION, WIDTH, HEIGHT, lowByte(WINDOW), highByte(WINDOW)};
+        sendFrame(INFO, info, sizeof(info));
+        break;
+    }
+    case FILL:
+        if (valid)
+        {
+            display->fillRect(header[0], header[1], header[2], header[3], header[4] | (header[5] << 8));
+        }
+        break;
+    case RECT:
+        if (!valid || pixelsLeft > 0)
+        {
+            sendError(ERROR_PAYLOAD);
+        }
+        break;
+    case EXTENDER:
+        controlPanel->extenderWriteMask(header[0], header[1]);
+        break;
+    default:
+        break;
+    }
+}
+
+bool Epson_PNL_CE02_Remote::startPayload()
+{
+    if (command != FILL && command != RECT)
+    {
+        return true;
+    }
+    const int16_t x = header[0];
+    const int16_t y = header[1];
+    const int16_t w = header[2];
+    const int16_t h = header[3];
+    if (w == 0 || h == 0 || x + w > WIDTH || y + h > HEIGHT)
+    {
+        return false;
+    }
+    if (command == RECT)
+    {
+        display->setWindow(x, y, x + w - 1, y + h - 1);
+        pixelsLeft = w * h;
+        tokenLeft = 0;
+        colorHigh = false;
+        buffered = 0;
+    }
+    return true;
+}
+
+void Epson_PNL_CE02_Remote::pushPixels(uint16_t color, uint16_t count)
+{
+    pixelsLeft -= count;
+    while (count > 0)
+    {
+        // Long runs are streamed at once, after an even number of buffered pixels to keep RGB444 pairs aligned
+        if (count >= RUN_MIN && buffered % 2 == 0)
+        {
+            flushPixels();
+            const uint16_t run = pixelsLeft == 0 ? count : count & ~1;
+            display->fillPixels(color, run);
+            count -= run;
+            continue;
+        }
+        pixels[buffered++] = color;
+        count--;
+        if (buffered == CHUNK)
+        {
+            flushPixels();
+        }
+    }
+    if (pixelsLeft == 0)
+    {
+        flushPixels();
+    }
+}
+
+void Epson_PNL_CE02_Remote::flushPixels()
+{
+    if (buffered > 0)
+    {
+        display->writePixels(pixels, buffered);
+        buffered = 0;
+    }
+}
+
+void Epson_PNL_CE02_Remote::scanButtons()
+{
+    const byte buttons = controlPanel->readButtons();
+    const bool power = controlPanel->isPowerButtonPressed();
+    if (buttons != lastButtons || power != lastPower)
+    {
+        lastButtons = buttons;
+        lastPower = power;
+        const byte event[] = {buttons, power ? byte(1) : byte(0)};
+        sendFrame(BUTTONS, event, sizeof(event));
+    }
+}
+
+void Epson_PNL_CE02_Remote::sendFrame(byte frameCommand, const byte *pPayload, uint16_t size)
+{
+    byte frame[4] = {SYNC_BYTE, frameCommand, lowByte(size), highByte(size)};
+    byte crc = 0;
+    for (byte index = 1; index < sizeof(frame); index++)
+    {
+        crc = crc8(crc, frame[index]);
+    }
+    for (uint16_t index = 0; index < size; index++)
+    {
+        crc = crc8(crc, pPayload[index]);
+    }
+    stream->write(frame, sizeof(frame));
+    stream->write(pPayload, size);
+    stream->write(crc);
+}
+
+void Epson_PNL_CE02_Remote::sendError(byte code)
+{
+    errorCount++;
+    const byte error[] = {code, command};
+    sendFrame(ERROR, error, sizeof(error));
+}
@@ -0,0 +1,160 @@
+/**
+ * @file Epson_PNL_CE02_Remote.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Host-driven display over a serial link, for the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * The host renders the screen and sends changed rectangles, the panel sends button events back. Every message is a
+ * frame: `0xA5 | command | length (2 bytes) | payload (length bytes) | CRC-8 (poly 0x07, of command to payload)`.
+ * Multi-byte values are little-endian, colors are RGB565.
+ *
+ * | Host to panel | Command | Payload                                                                       |
+ * |---------------|---------|-------------------------------------------------------------------------------|
+ * | PING          | 0x01    | -, answered by INFO                                                           |
+ * | FILL          | 0x10    | x, y, w, h, color (2 bytes)                                                   |
+ * | RECT          | 0x11    | x, y, w, h, then RLE tokens of w x h pixels, row by row:                     |
+ * |               |         |  => 0x80 + n - 1, color: run of n (1 to 128) pixels of a color                |
+ * |               |         |  => n - 1, n colors: n (1 to 128) literal pixels                              |
+ * | EXTENDER      | 0x20    | mask, value (refer to ExtenderPin)                                            |
+ *
+ * | Panel to host | Command | Payload                                                                       |
+ * |---------------|---------|-------------------------------------------------------------------------------|
+ * | INFO          | 0x81    | version, width, height, window (2 bytes)                                      |
+ * | CREDIT        | 0x82    | count (2 bytes) of bytes read since the last CREDIT                           |
+ * | BUTTONS       | 0x83    | buttons (refer to ButtonMask), power button (0 / 1)                          |
+ * | ERROR         | 0x84    | code (1: CRC, 2: unknown command, 3: invalid payload), command                |
+ *
+ * Flow control: after INFO, the host may send `window` bytes, then one more byte per byte granted by CREDIT. The
+ * serial receive buffer never overflows while the panel streams pixels to the display, and the host keeps sending
+ * during the display writes: RECT pixels are decoded and written as they arrive, their CRC is checked at the end.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_REMOTE_H
+#define EPSON_PNL_CE02_REMOTE_H
+
+#include <Arduino.h>
+#include <Epson_PNL_CE02.h>
+#include <Epson_PNL_CE02_Display.h>
+
+#ifndef EPSON_PNL_CE02_REMOTE_WINDOW
+#define EPSON_PNL_CE02_REMOTE_WINDOW 63 // bytes in flight, at most the size of the serial receive buffer minus 1
+#endif
+
+/**
+ * @brief Decoder of the frames sent by the host, and sender of the button events.
+ *
+ * @example
+ * ``` c++
+ * Epson_PNL_CE02_Remote remote(&controlPanel, &display, &Serial);
+ *
+ * void setup() {
+ *     Serial.begin(1000000);
+ *     controlPanel.begin();
+ *     display.begin();
+ *     remote.begin();
+ * }
+ *
+ * void loop() {
+ *     remote.update();
+ * }
+ * ```
+ */
+class Epson_PNL_CE02_Remote // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    static const uint16_t WINDOW = EPSON_PNL_CE02_REMOTE_WINDOW;
+
+    /**
+     * @brief Construct a new Epson_PNL_CE02_Remote object.
+     *
+     * @param pControlPanel Reference to the control panel, buttons and extender.
+     * @param pDisplay Reference to the display receiving the frames.
+     * @param pStream serial link to the host, e.g. &Serial
+     */
+    Epson_PNL_CE02_Remote(Epson_PNL_CE02 *pControlPanel, Epson_PNL_CE02_Display *pDisplay, Stream *pStream);
+
+    /**
+     * @brief Announce the panel to the host (INFO).
+     *
+     * @param scanInterval milliseconds between two button scans
+     */
+    void begin(uint16_t scanInterval = 10);
+
+    /**
+     * @brief Decode the bytes received, grant credits and send button events. Call it as often as possible.
+     */
+    void update();
+
+    /**
+     * @brief Number of frames rejected since begin().
+     */
+    uint16_t errors() const;
+
+  private:
+    enum class State : byte
+    {
+        SYNC,
+        COMMAND,
+        LENGTH_LOW,
+        LENGTH_HIGH,
+        PAYLOAD,
+        CHECKSUM,
+    };
+
+    static const byte HEADER_SIZE = 6; // largest fixed part of a payload
+    static const byte CHUNK = 32;      // decoded pixels written at once, even for RGB444
+
+    Epson_PNL_CE02 *controlPanel;
+    Epson_PNL_CE02_Display *display;
+    Stream *stream;
+    uint16_t scanInterval = 10;
+    uint32_t lastScan = 0;
+    byte lastButtons = 0;
+    bool lastPower = false;
+    uint16_t received = 0; // bytes read since the last CREDIT
+    uint16_t errorCount = 0;
+
+    // Frame being decoded
+    State state = State::SYNC;
+    byte command = 0;
+    uint16_t length = 0;
+    uint16_t position = 0;
+    byte checksum = 0;
+    byte header[HEADER_SIZE] = {};
+
+    // RECT pixels
+    uint16_t pixelsLeft = 0; // pixels of the rectangle not decoded yet
+    byte tokenLeft = 0;      // pixels of the current token, 0: the next byte is a token
+    bool tokenRun = false;
+    bool colorHigh = false; // the next byte is the high byte of a color
+    byte colorLow = 0;
+    bool valid = false; // the rectangle and its pixels fit the screen
+    uint16_t pixels[CHUNK];
+    byte buffered = 0;
+
+    void receive(byte value);
+    void receivePayload(byte value);
+    void receivePixelByte(byte value);
+    void endFrame();
+
+    /**
+     * @brief Determine if the fixed part of the payload is valid, and start a RECT.
+     */
+    bool startPayload();
+
+    /**
+     * @brief Write pixels of a color in the window, through the chunk buffer or as a single run.
+     */
+    void pushPixels(uint16_t color, uint16_t count);
+    void flushPixels();
+
+    void scanButtons();
+    void sendFrame(byte frameCommand, const byte *pPayload, uint16_t size);
+    void sendError(byte code);
+};
+
+#endif // EPSON_PNL_CE02_REMOTE_H
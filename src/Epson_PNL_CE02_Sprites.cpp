@@ -0,0 +1,254 @@
+/**
+ * @file Epson_PNL_CE02_Sprites.cpp
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Sprite layer of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#include "Epson_PNL_CE02_Sprites.h"
+#include <Arduino.h>
+
+namespace
+{
+const int16_t WIDTH = Epson_PNL_CE02_Display::WIDTH;
+const int16_t HEIGHT = Epson_PNL_CE02_Display::HEIGHT;
+} // namespace
+
+// CTOR
+Epson_PNL_CE02_Sprites::Epson_PNL_CE02_Sprites(Epson_PNL_CE02_Display *pDisplay) : display(pDisplay), sprites()
+{
+}
+
+// PUBLICS
+void Epson_PNL_CE02_Sprites::setBackground(uint16_t color)
+{
+    background = color;
+}
+
+void Epson_PNL_CE02_Sprites::setBackground(const Epson_PNL_CE02_Tilemap *pTilemap)
+{
+    tilemap = pTilemap;
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Sprites::setBitmap(byte sprite, const uint16_t *pBitmap, byte w, byte h, uint16_t transparent)
+{
+    if (sprite >= MAX_SPRITES)
+    {
+        return;
+    }
+    Sprite &target = sprites[sprite];
+    target.pBitmap = pBitmap;
+    target.w = w;
+    target.h = h;
+    target.transparent = transparent;
+    target.visible = true;
+    target.dirty = true;
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Sprites::moveTo(byte sprite, int16_t x, int16_t y)
+{
+    if (sprite >= MAX_SPRITES)
+    {
+        return;
+    }
+    Sprite &target = sprites[sprite];
+    if (target.x != x || target.y != y)
+    {
+        target.x = x;
+        target.y = y;
+        target.dirty = true;
+    }
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Sprites::setVisible(byte sprite, bool visible)
+{
+    if (sprite >= MAX_SPRITES)
+    {
+        return;
+    }
+    Sprite &target = sprites[sprite];
+    if (target.visible != visible)
+    {
+        target.visible = visible;
+        target.dirty = true;
+    }
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Sprites::drawAll()
+{
+    compose(0, 0, WIDTH, HEIGHT);
+    for (Sprite &sprite : sprites)
+    {
+        sprite.drawn = sprite.visible && sprite.pBitmap != nullptr;
+        sprite.drawnX = sprite.x;
+        sprite.drawnY = sprite.y;
+        sprite.drawnW = sprite.w;
+        sprite.drawnH = sprite.h;
+        sprite.dirty = false;
+    }
+}
+
+uint32_t Epson_PNL_CE02_Sprites::update()
+{
+    uint32_t sent = 0;
+    for (Sprite &sprite : sprites)
+    {
+        if (!sprite.dirty)
+        {
+            continue;
+        }
+        const bool shown = sprite.visible && sprite.pBitmap != nullptr;
+        if (sprite.drawn && shown)
+        {
+            // Union of the old and new rectangles, unless they are far apart
+            const int16_t x0 = sprite.drawnX < sprite.x ? sprite.drawnX : sprite.x;
+            const int16_t y0 = sprite.drawnY < sprite.y ? sprite.drawnY : sprite.y;
+            const int16_t drawnRight = sprite.drawnX + sprite.drawnW;
+            const int16_t drawnBottom = sprite.drawnY + sprite.drawnH;
+            const int16_t x1 = drawnRight > sprite.x + sprite.w ? drawnRight : sprite.x + sprite.w;
+            const int16_t y1 = drawnBottom > sprite.y + sprite.h ? drawnBottom : sprite.y + sprite.h;
+            const uint32_t unionArea = static_cast<uint32_t>(x1 - x0) * (y1 - y0);
+            const uint32_t areas = static_cast<uint32_t>(sprite.drawnW) * sprite.drawnH +
+                                   static_cast<uint32_t>(sprite.w) * sprite.h;
+            if (unionArea <= areas)
+            {
+                sent += compose(x0, y0, x1 - x0, y1 - y0);
+            }
+            else
+            {
+                sent += compose(sprite.drawnX, sprite.drawnY, sprite.drawnW, sprite.drawnH);
+                sent += compose(sprite.x, sprite.y, sprite.w, sprite.h);
+            }
+        }
+        else if (sprite.drawn)
+        {
+            sent += compose(sprite.drawnX, sprite.drawnY, sprite.drawnW, sprite.drawnH);
+        }
+        else if (shown)
+        {
+            sent += compose(sprite.x, sprite.y, sprite.w, sprite.h);
+        }
+
+        sprite.drawn = shown;
+        sprite.drawnX = sprite.x;
+        sprite.drawnY = sprite.y;
+        sprite.drawnW = sprite.w;
+        sprite.drawnH = sprite.h;
+        sprite.dirty = false;
+    }
+    return sent;
+}
+
+// PRIVATES
+uint16_t Epson_PNL_CE02_Sprites::compose(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    if (x < 0)
+    {
+        w += x;
+        x = 0;
+    }
+    if (y < 0)
+    {
+        h += y;
+        y = 0;
+    }
+    if (x + w > WIDTH)
+    {
+        w = WIDTH - x;
+    }
+    if (y + h > HEIGHT)
+    {
+        h = HEIGHT - y;
+    }
+    if (w <= 0 || h <= 0)
+    {
+        return 0;
+    }
+
+    // Rows of an even width: in RGB444, a row of an odd number of pixels would end the RAMWR burst
+    if (w % 2 != 0)
+    {
+        if (x + w < WIDTH)
+        {
+            w++;
+        }
+        else
+        {
+            x--;
+            w++;
+        }
+    }
+
+    for (int16_t left = x; left < x + w; left += LINE_PIXELS)
+    {
+        const int16_t strip = x + w - left < LINE_PIXELS ? x + w - left : LINE_PIXELS;
+        composeWindow(left, y, strip, h);
+    }
+    return static_cast<uint16_t>(w * h);
+}
+
+void Epson_PNL_CE02_Sprites::composeWindow(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    display->setWindow(x, y, x + w - 1, y + h - 1);
+    uint16_t line[LINE_PIXELS];
+    for (int16_t row = y; row < y + h; row++)
+    {
+        backgroundRow(line, x, row, w);
+
+        // Opaque pixels of the sprites crossing the row, in order
+        for (const Sprite &sprite : sprites)
+        {
+            if (!sprite.visible || sprite.pBitmap == nullptr || row < sprite.y || row >= sprite.y + sprite.h)
+            {
+                continue;
+            }
+            const int16_t from = sprite.x > x ? sprite.x : x;
+            const int16_t to = sprite.x + sprite.w < x + w ? sprite.x + sprite.w : x + w;
+            const uint16_t *pPixel = sprite.pBitmap + (row - sprite.y) * sprite.w + (from - sprite.x);
+            for (int16_t column = from; column < to; column++)
+            {
+                const uint16_t color = pgm_read_word(pPixel++);
+                if (color != sprite.transparent)
+                {
+                    line[column - x] = color;
+                }
+            }
+        }
+        display->writePixels(line, w);
+    }
+}
+
+void Epson_PNL_CE02_Sprites::backgroundRow(uint16_t *pLine, int16_t x, int16_t y, int16_t w) const
+{
+    int16_t column = 0;
+    // Right of the map, the first tile would be read past its last row
+    if (tilemap != nullptr && x < tilemap->columns * tilemap->size && y < tilemap->rows * tilemap->size)
+    {
+        const byte size = tilemap->size;
+        const int16_t mapWidth = tilemap->columns * size;
+        const byte *pIndex = tilemap->pMap + (y / size) * tilemap->columns + x / size;
+        const uint16_t tileRow = (y % size) * size;
+        byte offset = x % size;
+        const uint16_t *pTile = tilemap->pTiles + (pgm_read_byte(pIndex) * size) * size + tileRow;
+        for (; column < w && x + column < mapWidth; column++)
+        {
+            pLine[column] = pgm_read_word(pTile + offset);
+            if (++offset == size && x + column + 1 < mapWidth)
+            {
+                offset = 0;
+                pTile = tilemap->pTiles + (pgm_read_byte(++pIndex) * size) * size + tileRow;
+            }
+        }
+    }
+    for (; column < w; column++)
+    {
+        pLine[column] = background;
+    }
+}
@@ -0,0 +1,165 @@
+/**
+ * @file Epson_PNL_CE02_Sprites.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Sprite layer of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * The display is write-only: what lies under a moving sprite cannot be read back. Sprites are composed over a
+ * background that can be recomputed at any time, a solid color or a PROGMEM tilemap, without framebuffer:
+ *  => a sprite move repaints the union of its old and new rectangles (or both rectangles when far apart)
+ *  => the rectangle is composed row by row in a scanline buffer, background then sprites in order, and streamed
+ *     through a single window
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_SPRITES_H
+#define EPSON_PNL_CE02_SPRITES_H
+
+#include <Arduino.h>
+#include <Epson_PNL_CE02_Display.h>
+
+#ifndef EPSON_PNL_CE02_SPRITES
+#define EPSON_PNL_CE02_SPRITES 8 // sprites, drawn in order (the last on top)
+#endif
+
+#ifndef EPSON_PNL_CE02_SPRITE_LINE
+#define EPSON_PNL_CE02_SPRITE_LINE 64 // pixels of the scanline buffer, wider rectangles are split
+#endif
+
+/**
+ * @brief Background made of square RGB565 tiles, stored in flash memory (PROGMEM).
+ * The screen outside of the map shows the background color.
+ */
+struct Epson_PNL_CE02_Tilemap // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+    const uint16_t *pTiles; // tiles in PROGMEM, `size` x `size` pixels each, row by row
+    const byte *pMap;       // tile indexes in PROGMEM, `columns` x `rows`, row by row
+    byte size;              // tile size in pixels
+    byte columns;           // tiles per row of the map
+    byte rows;              // rows of the map
+};
+
+/**
+ * @brief Sprites over a solid or tiled background, repainted where they moved.
+ *
+ * @example
+ * ``` c++
+ * Epson_PNL_CE02_Sprites sprites(&display);
+ * sprites.setBackground(&TILEMAP);
+ * sprites.setBitmap(0, CURSOR, 8, 8, 0xF81F); // magenta is transparent
+ * sprites.drawAll();
+ *
+ * sprites.moveTo(0, x, y);
+ * sprites.update(); // repaints the cursor area only
+ * ```
+ */
+class Epson_PNL_CE02_Sprites // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    static const byte MAX_SPRITES = EPSON_PNL_CE02_SPRITES;
+    static const byte LINE_PIXELS = EPSON_PNL_CE02_SPRITE_LINE;
+
+    /**
+     * @brief Construct a new Epson_PNL_CE02_Sprites object, black background, sprites hidden.
+     *
+     * @param pDisplay Reference to the display receiving the sprites.
+     */
+    explicit Epson_PNL_CE02_Sprites(Epson_PNL_CE02_Display *pDisplay);
+
+    /**
+     * @brief Set the background color, shown outside of the tilemap. Call drawAll() to repaint the screen.
+     *
+     * @param color RGB565 color
+     */
+    void setBackground(uint16_t color);
+
+    /**
+     * @brief Set the tilemap shown under the sprites. Call drawAll() to repaint the screen.
+     *
+     * @param pTilemap tilemap, kept, nullptr for the background color only
+     */
+    void setBackground(const Epson_PNL_CE02_Tilemap *pTilemap);
+
+    /**
+     * @brief Set the image of a sprite and show it, e.g. the next frame of an animation.
+     *
+     * @param sprite 0 to MAX_SPRITES - 1
+     * @param pBitmap RGB565 pixels in PROGMEM, row by row
+     * @param w width
+     * @param h height
+     * @param transparent color not drawn
+     */
+    void setBitmap(byte sprite, const uint16_t *pBitmap, byte w, byte h, uint16_t transparent);
+
+    /**
+     * @brief Move a sprite, repainted by the next update().
+     *
+     * @param x left column, may be out of the screen
+     * @param y top row, may be out of the screen
+     */
+    void moveTo(byte sprite, int16_t x, int16_t y);
+
+    /**
+     * @brief Show or hide a sprite.
+     */
+    void setVisible(byte sprite, bool visible);
+
+    /**
+     * @brief Repaint the whole screen, background and sprites.
+     */
+    void drawAll();
+
+    /**
+     * @brief Repaint the areas of the sprites changed since the last update().
+     *
+     * @return uint32_t number of pixels sent
+     */
+    uint32_t update();
+
+  private:
+    struct Sprite
+    {
+        const uint16_t *pBitmap;
+        uint16_t transparent;
+        int16_t x;
+        int16_t y;
+        byte w;
+        byte h;
+        bool visible;
+        bool dirty;
+
+        // Rectangle on screen
+        int16_t drawnX;
+        int16_t drawnY;
+        byte drawnW;
+        byte drawnH;
+        bool drawn;
+    };
+
+    Epson_PNL_CE02_Display *display;
+    const Epson_PNL_CE02_Tilemap *tilemap = nullptr;
+    uint16_t background = 0x0000;
+    Sprite sprites[MAX_SPRITES];
+
+    /**
+     * @brief Compose and send a rectangle, clipped to the screen, through a window per LINE_PIXELS columns.
+     *
+     * @return uint16_t number of pixels sent
+     */
+    uint16_t compose(int16_t x, int16_t y, int16_t w, int16_t h);
+
+    /**
+     * @brief Compose and send a rectangle on screen, at most LINE_PIXELS wide, through a single window.
+     */
+    void composeWindow(int16_t x, int16_t y, int16_t w, int16_t h);
+
+    /**
+     * @brief Fill a row of the scanline buffer with the background.
+     */
+    void backgroundRow(uint16_t *pLine, int16_t x, int16_t y, int16_t w) const;
+};
+
+#endif // EPSON_PNL_CE02_SPRITES_H
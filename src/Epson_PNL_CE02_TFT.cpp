@@ -0,0 +1,99 @@
+/**
+ * @file Epson_PNL_CE02_TFT.cpp
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Adafruit_GFX interface for the display of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#include "Epson_PNL_CE02_TFT.h"
+#include <Arduino.h>
+
+// CTOR
+Epson_PNL_CE02_TFT::Epson_PNL_CE02_TFT(Epson_PNL_CE02 *pControlPanel)
+    : Adafruit_GFX(Epson_PNL_CE02_Display::WIDTH, Epson_PNL_CE02_Display::HEIGHT), lcd(pControlPanel)
+{
+}
+
+// PUBLICS
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_TFT::begin(const byte *pSplash)
+{
+    lcd.begin(pSplash);
+}
+
+// cppcheck-suppress unusedFunction
+Epson_PNL_CE02_Display &Epson_PNL_CE02_TFT::display()
+{
+    return lcd;
+}
+
+void Epson_PNL_CE02_TFT::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    lcd.drawPixel(x, y, color);
+}
+
+void Epson_PNL_CE02_TFT::writePixel(int16_t x, int16_t y, uint16_t color)
+{
+    lcd.drawPixel(x, y, color);
+}
+
+void Epson_PNL_CE02_TFT::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    lcd.fillRect(x, y, w, h, color);
+}
+
+void Epson_PNL_CE02_TFT::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    lcd.fillRect(x, y, w, 1, color);
+}
+
+void Epson_PNL_CE02_TFT::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+    lcd.fillRect(x, y, 1, h, color);
+}
+
+void Epson_PNL_CE02_TFT::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    lcd.fillRect(x, y, w, 1, color);
+}
+
+void Epson_PNL_CE02_TFT::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+    lcd.fillRect(x, y, 1, h, color);
+}
+
+void Epson_PNL_CE02_TFT::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    lcd.fillRect(x, y, w, h, color);
+}
+
+void Epson_PNL_CE02_TFT::fillScreen(uint16_t color)
+{
+    lcd.fillRect(0, 0, _width, _height, color);
+}
+
+void Epson_PNL_CE02_TFT::setRotation(uint8_t r)
+{
+    Adafruit_GFX::setRotation(r);
+    lcd.setRotation(rotation);
+}
+
+void Epson_PNL_CE02_TFT::invertDisplay(bool i)
+{
+    lcd.invertDisplay(i);
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_TFT::drawRGBBitmap(int16_t x, int16_t y, const uint16_t bitmap[], int16_t w, int16_t h)
+{
+    lcd.drawBitmap_P(x, y, bitmap, w, h);
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_TFT::drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h)
+{
+    lcd.drawBitmap(x, y, bitmap, w, h);
+}
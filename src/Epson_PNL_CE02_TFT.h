@@ -0,0 +1,87 @@
+/**
+ * @file Epson_PNL_CE02_TFT.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Adafruit_GFX interface for the display of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * Primitives are overridden with window-addressed bulk writes (refer to Epson_PNL_CE02_Display), everything else
+ * (text, lines, circles...) comes from Adafruit_GFX.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_TFT_H
+#define EPSON_PNL_CE02_TFT_H
+
+#include <Adafruit_GFX.h>
+#include <Arduino.h>
+#include <Epson_PNL_CE02.h>
+#include <Epson_PNL_CE02_Display.h>
+
+/**
+ * @brief Adafruit_GFX display of the control panel.
+ *
+ * @example
+ * ``` c++
+ * Epson_PNL_CE02_TFT tft(&controlPanel);
+ * tft.begin();
+ * tft.fillScreen(0xF800); // red
+ * tft.print("Hello World");
+ * ```
+ */
+class Epson_PNL_CE02_TFT : public Adafruit_GFX // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    /**
+     * @brief Construct a new Epson_PNL_CE02_TFT object
+     *
+     * @param pControlPanel Reference to the Epson_PNL_CE02 controlling the display.
+     */
+    explicit Epson_PNL_CE02_TFT(Epson_PNL_CE02 *pControlPanel);
+
+    /**
+     * @brief Reset and initialize the display, then turn the backlight on.
+     * Epson_PNL_CE02::begin() must be called before.
+     *
+     * @param pSplash compressed image in PROGMEM shown centered on black, refer to Epson_PNL_CE02_Display::begin()
+     */
+    void begin(const byte *pSplash = nullptr);
+
+    /**
+     * @brief Window-addressed driver, for direct pixels streaming.
+     *
+     * @return Epson_PNL_CE02_Display& driver
+     */
+    Epson_PNL_CE02_Display &display();
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void writePixel(int16_t x, int16_t y, uint16_t color) override;
+    void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void fillScreen(uint16_t color) override;
+    void setRotation(uint8_t r) override;
+    void invertDisplay(bool i) override;
+
+    using Adafruit_GFX::drawRGBBitmap;
+
+    /**
+     * @brief Draw a RGB565 bitmap stored in flash memory (PROGMEM) through a single window.
+     */
+    void drawRGBBitmap(int16_t x, int16_t y, const uint16_t bitmap[], int16_t w, int16_t h);
+
+    /**
+     * @brief Draw a RGB565 bitmap stored in RAM through a single window.
+     */
+    void drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h);
+
+  private:
+    Epson_PNL_CE02_Display lcd;
+};
+
+#endif // EPSON_PNL_CE02_TFT_H
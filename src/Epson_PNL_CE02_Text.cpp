@@ -0,0 +1,216 @@
+/**
+ * @file Epson_PNL_CE02_Text.cpp
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Text renderer of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#include "Epson_PNL_CE02_Text.h"
+#include <Arduino.h>
+
+namespace
+{
+const byte CHUNK_PIXELS = 32; // converted pixels streamed at once
+const byte MAX_SCALE = 8;
+const byte MAX_NUMBER_COLUMNS = 11; // "-2147483648"
+const byte MAX_LINE_LENGTH = 0xFF;
+const uint32_t LEFT_BIT = 0x80000000UL;
+const int16_t WIDTH = Epson_PNL_CE02_Display::WIDTH;
+const int16_t HEIGHT = Epson_PNL_CE02_Display::HEIGHT;
+const int16_t MAX_COLUMN = 0x7FFF;
+} // namespace
+
+// CTOR
+Epson_PNL_CE02_Text::Epson_PNL_CE02_Text(Epson_PNL_CE02_Display *pDisplay, const Epson_PNL_CE02_Font *pFont)
+    : display(pDisplay), font(pFont)
+{
+}
+
+// PUBLICS
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Text::setFont(const Epson_PNL_CE02_Font *pFont)
+{
+    font = pFont;
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Text::setColors(uint16_t foreground, uint16_t background)
+{
+    this->foreground = foreground;
+    this->background = background;
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Text::setScale(byte scale)
+{
+    this->scale = scale < 1 ? 1 : (scale > MAX_SCALE ? MAX_SCALE : scale);
+}
+
+int16_t Epson_PNL_CE02_Text::charWidth() const
+{
+    return static_cast<int16_t>(font->width) * scale;
+}
+
+int16_t Epson_PNL_CE02_Text::lineHeight() const
+{
+    return static_cast<int16_t>(font->height) * scale;
+}
+
+// cppcheck-suppress unusedFunction
+int16_t Epson_PNL_CE02_Text::textWidth(const char *pText) const
+{
+    int16_t length = 0;
+    while (pText[length] != '\0' && pText[length] != '\n' && length < MAX_LINE_LENGTH)
+    {
+        length++;
+    }
+    return length * charWidth();
+}
+
+int16_t Epson_PNL_CE02_Text::drawText(int16_t x, int16_t y, const char *pText, byte columns)
+{
+    byte length = 0;
+    while (pText[length] != '\0' && pText[length] != '\n' && length < MAX_LINE_LENGTH)
+    {
+        length++;
+    }
+    if (columns == 0)
+    {
+        columns = length;
+    }
+    return drawLine(x, y, columns, [&](byte index) { return index < length ? pText[index] : ' '; });
+}
+
+// cppcheck-suppress unusedFunction
+int16_t Epson_PNL_CE02_Text::drawText_P(int16_t x, int16_t y, const char *pText, byte columns)
+{
+    byte length = 0;
+    while (length < MAX_LINE_LENGTH)
+    {
+        const char character = static_cast<char>(pgm_read_byte(pText + length));
+        if (character == '\0' || character == '\n')
+        {
+            break;
+        }
+        length++;
+    }
+    if (columns == 0)
+    {
+        columns = length;
+    }
+    return drawLine(x, y, columns,
+                    [&](byte index) { return index < length ? static_cast<char>(pgm_read_byte(pText + index)) : ' '; });
+}
+
+// cppcheck-suppress unusedFunction
+int16_t Epson_PNL_CE02_Text::drawChars(int16_t x, int16_t y, const char *pChars, byte count)
+{
+    return drawLine(x, y, count, [&](byte index) { return pChars[index]; });
+}
+
+// cppcheck-suppress unusedFunction
+int16_t Epson_PNL_CE02_Text::drawNumber(int16_t x, int16_t y, long value, byte columns)
+{
+    columns = columns < 1 ? 1 : (columns > MAX_NUMBER_COLUMNS ? MAX_NUMBER_COLUMNS : columns);
+
+    // Digits from the right, then the sign
+    char field[MAX_NUMBER_COLUMNS];
+    unsigned long magnitude = value < 0 ? 0UL - static_cast<unsigned long>(value) : static_cast<unsigned long>(value);
+    int8_t position = static_cast<int8_t>(columns);
+    do
+    {
+        field[--position] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0 && position > 0);
+    if (value < 0 && position > 0)
+    {
+        field[--position] = '-';
+    }
+    const bool overflow = magnitude != 0 || (value < 0 && field[position] != '-');
+    for (byte index = 0; index < columns; index++)
+    {
+        if (overflow)
+        {
+            field[index] = '#';
+        }
+        else if (index < position)
+        {
+            field[index] = ' ';
+        }
+    }
+    return drawLine(x, y, columns, [&](byte index) { return field[index]; });
+}
+
+// PRIVATES
+template <class Character> int16_t Epson_PNL_CE02_Text::drawLine(int16_t x, int16_t y, byte length, Character character)
+{
+    const int16_t cellWidth = charWidth();
+    const int32_t right = x + static_cast<int32_t>(length) * cellWidth;
+    const int32_t bottom = y + static_cast<int32_t>(lineHeight());
+    const int16_t x0 = x < 0 ? 0 : x;
+    const int16_t y0 = y < 0 ? 0 : y;
+    const int16_t x1 = static_cast<int16_t>((right < WIDTH ? right : WIDTH) - 1);
+    const int16_t y1 = static_cast<int16_t>((bottom < HEIGHT ? bottom : HEIGHT) - 1);
+    const int16_t next = right > MAX_COLUMN ? MAX_COLUMN : static_cast<int16_t>(right);
+    if (x0 > x1 || y0 > y1)
+    {
+        return next;
+    }
+
+    display->setWindow(x0, y0, x1, y1);
+
+    // Rows of the window cross every visible character, pixels are streamed back to back
+    const byte rowBytes = (font->width + 7) / 8;
+    const size_t glyphBytes = static_cast<size_t>(rowBytes) * font->height;
+    const uint16_t firstIndex = (x0 - static_cast<int32_t>(x)) / cellWidth;
+    const uint16_t lastIndex = (x1 - static_cast<int32_t>(x)) / cellWidth;
+    uint16_t chunk[CHUNK_PIXELS];
+    byte count = 0;
+    for (int16_t line = y0 - y; line <= y1 - y; line++)
+    {
+        const byte glyphRow = line / scale;
+        for (uint16_t index = firstIndex; index <= lastIndex; index++)
+        {
+            // Glyph row, left aligned
+            const byte code = static_cast<byte>(character(static_cast<byte>(index)));
+            uint32_t bits = 0;
+            if (code >= font->first && code <= font->last)
+            {
+                const byte *pRow = font->pGlyphs + (code - font->first) * glyphBytes + glyphRow * rowBytes;
+                for (byte offset = 0; offset < rowBytes; offset++)
+                {
+                    bits |= static_cast<uint32_t>(pgm_read_byte(pRow + offset)) << (24 - 8 * offset);
+                }
+            }
+
+            // Visible pixels of the cell
+            const int32_t cellX = x + static_cast<int32_t>(index) * cellWidth;
+            const int16_t from = static_cast<int16_t>(cellX < x0 ? x0 - cellX : 0);
+            const int16_t to = static_cast<int16_t>(cellX + cellWidth - 1 > x1 ? x1 - cellX + 1 : cellWidth);
+            bits <<= from / scale;
+            byte repeat = from % scale;
+            for (int16_t pixel = from; pixel < to; pixel++)
+            {
+                chunk[count++] = (bits & LEFT_BIT) != 0 ? foreground : background;
+                if (++repeat == scale)
+                {
+                    repeat = 0;
+                    bits <<= 1;
+                }
+                if (count == CHUNK_PIXELS)
+                {
+                    display->writePixels(chunk, count);
+                    count = 0;
+                }
+            }
+        }
+    }
+    if (count > 0)
+    {
+        display->writePixels(chunk, count);
+    }
+    return next;
+}
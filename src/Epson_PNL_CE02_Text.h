@@ -0,0 +1,135 @@
+/**
+ * @file Epson_PNL_CE02_Text.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Text renderer of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * A line of text is drawn through a single window: the glyph rows of all its characters are streamed back to back,
+ * foreground and background colors included, instead of a window per pixel (Adafruit_GFX print()).
+ * Text is opaque and fixed-width (refer to Epson_PNL_CE02_Font): a field drawn again over itself needs no erase.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_TEXT_H
+#define EPSON_PNL_CE02_TEXT_H
+
+#include <Arduino.h>
+#include <Epson_PNL_CE02_Display.h>
+#include <Epson_PNL_CE02_Font.h>
+
+/**
+ * @brief Opaque fixed-width text, a window per line.
+ *
+ * @example
+ * ``` c++
+ * Epson_PNL_CE02_Text text(&display);
+ * text.setColors(0xFFFF, 0x0000); // white on black
+ * text.drawText(0, 0, "Ink level");
+ * text.drawNumber(0, 8, level, 3); // right aligned in 3 columns, previous value overwritten
+ * ```
+ */
+class Epson_PNL_CE02_Text // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    /**
+     * @brief Construct a new Epson_PNL_CE02_Text object, white on black.
+     *
+     * @param pDisplay Reference to the display receiving the text.
+     * @param pFont font (default: EPSON_PNL_CE02_FONT_6X8)
+     */
+    explicit Epson_PNL_CE02_Text(Epson_PNL_CE02_Display *pDisplay,
+                                 const Epson_PNL_CE02_Font *pFont = &EPSON_PNL_CE02_FONT_6X8);
+
+    void setFont(const Epson_PNL_CE02_Font *pFont);
+
+    /**
+     * @brief Set the colors of the next texts.
+     *
+     * @param foreground RGB565 color of the glyphs
+     * @param background RGB565 color of the rest of the character cells
+     */
+    void setColors(uint16_t foreground, uint16_t background);
+
+    /**
+     * @brief Magnify the next texts.
+     *
+     * @param scale 1 to 8, pixels of the screen per pixel of the font
+     */
+    void setScale(byte scale);
+
+    /**
+     * @brief Width of a character cell, scale included.
+     */
+    int16_t charWidth() const;
+
+    /**
+     * @brief Height of a line, scale included.
+     */
+    int16_t lineHeight() const;
+
+    /**
+     * @brief Width of a text, up to the end of its first line.
+     */
+    int16_t textWidth(const char *pText) const;
+
+    /**
+     * @brief Draw a line of text through a single window, clipped to the screen.
+     * The line ends at the end of the text or at the first '\n'. Characters missing from the font are blank.
+     *
+     * @param x left column
+     * @param y top row
+     * @param pText text
+     * @param columns field width in characters, the text is padded with spaces or truncated (0: text width)
+     * @return int16_t column following the line
+     */
+    int16_t drawText(int16_t x, int16_t y, const char *pText, byte columns = 0);
+
+    /**
+     * @brief Same as drawText() with a text stored in flash memory (PROGMEM).
+     */
+    // NOLINTNEXTLINE(readability-identifier-naming): Arduino PROGMEM suffix
+    int16_t drawText_P(int16_t x, int16_t y, const char *pText, byte columns = 0);
+
+    /**
+     * @brief Draw characters through a single window, clipped to the screen. Control characters are not interpreted.
+     *
+     * @param x left column
+     * @param y top row
+     * @param pChars characters, not terminated
+     * @param count number of characters
+     * @return int16_t column following the characters
+     */
+    int16_t drawChars(int16_t x, int16_t y, const char *pChars, byte count);
+
+    /**
+     * @brief Draw a number right aligned in a fixed-width field, the previous value is overwritten.
+     * A number wider than the field is drawn as '#' characters.
+     *
+     * @param x left column
+     * @param y top row
+     * @param value number
+     * @param columns field width in characters, 1 to 11
+     * @return int16_t column following the field
+     */
+    int16_t drawNumber(int16_t x, int16_t y, long value, byte columns);
+
+  private:
+    Epson_PNL_CE02_Display *display;
+    const Epson_PNL_CE02_Font *font;
+    uint16_t foreground = 0xFFFF;
+    uint16_t background = 0x0000;
+    byte scale = 1;
+
+    /**
+     * @brief Stream a line through a single window.
+     *
+     * @param length number of characters
+     * @param character character at an index, 0 to length - 1
+     */
+    template <class Character> int16_t drawLine(int16_t x, int16_t y, byte length, Character character);
+};
+
+#endif // EPSON_PNL_CE02_TEXT_H
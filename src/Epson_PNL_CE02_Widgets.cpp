@@ -0,0 +1,451 @@
+/**
+ * @file Epson_PNL_CE02_Widgets.cpp
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Retained-mode widgets of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#include "Epson_PNL_CE02_Widgets.h"
+#include <Arduino.h>
+
+namespace
+{
+const byte BUTTONS = 8;
+
+/**
+ * @brief Fill the columns of a row of text not covered by whole characters.
+ */
+void fillRest(Epson_PNL_CE02_Screen &screen, int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    const int16_t used = w / screen.text().charWidth() * screen.text().charWidth();
+    if (used < w)
+    {
+        screen.display().fillRect(x + used, y, w - used, screen.text().lineHeight(), color);
+    }
+}
+
+/**
+ * @brief Number of characters of a number, sign included.
+ */
+byte numberColumns(long value)
+{
+    byte columns = value < 0 ? 2 : 1;
+    unsigned long magnitude = value < 0 ? 0UL - static_cast<unsigned long>(value) : static_cast<unsigned long>(value);
+    while (magnitude >= 10)
+    {
+        magnitude /= 10;
+        columns++;
+    }
+    return columns;
+}
+} // namespace
+
+// WIDGET
+Epson_PNL_CE02_Widget::Epson_PNL_CE02_Widget(int16_t x, int16_t y, int16_t w) : x(x), y(y), w(w)
+{
+}
+
+void Epson_PNL_CE02_Widget::invalidate()
+{
+    dirty = true;
+    whole = true;
+}
+
+// cppcheck-suppress unusedFunction
+bool Epson_PNL_CE02_Widget::isDirty() const
+{
+    return dirty;
+}
+
+bool Epson_PNL_CE02_Widget::isFocusable() const
+{
+    return false;
+}
+
+bool Epson_PNL_CE02_Widget::press(ButtonMask /*button*/)
+{
+    return false;
+}
+
+void Epson_PNL_CE02_Widget::markChanged()
+{
+    dirty = true;
+}
+
+// LABEL
+Epson_PNL_CE02_Label::Epson_PNL_CE02_Label(int16_t x, int16_t y, int16_t w, const char *pText)
+    : Epson_PNL_CE02_Widget(x, y, w), text(pText)
+{
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Label::setText(const char *pText)
+{
+    text = pText;
+    markChanged();
+}
+
+void Epson_PNL_CE02_Label::draw(Epson_PNL_CE02_Screen &screen, bool /*focused*/, bool whole)
+{
+    // Padded to the width: the previous text is overwritten
+    screen.text().setColors(screen.foreground(), screen.background());
+    screen.text().drawText(x, y, text, w / screen.text().charWidth());
+    if (whole)
+    {
+        fillRest(screen, x, y, w, screen.background());
+    }
+}
+
+// PROGRESS BAR
+Epson_PNL_CE02_ProgressBar::Epson_PNL_CE02_ProgressBar(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t maximum)
+    : Epson_PNL_CE02_Widget(x, y, w), h(h), maximum(maximum > 0 ? maximum : 1)
+{
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_ProgressBar::setValue(uint16_t value)
+{
+    value = value > maximum ? maximum : value;
+    if (value != current)
+    {
+        current = value;
+        markChanged();
+    }
+}
+
+// cppcheck-suppress unusedFunction
+uint16_t Epson_PNL_CE02_ProgressBar::value() const
+{
+    return current;
+}
+
+void Epson_PNL_CE02_ProgressBar::draw(Epson_PNL_CE02_Screen &screen, bool /*focused*/, bool whole)
+{
+    Epson_PNL_CE02_Display &display = screen.display();
+    const int16_t inner = w - 2;
+    const int16_t fill = static_cast<int16_t>(static_cast<uint32_t>(inner) * current / maximum);
+    if (whole)
+    {
+        display.fillRect(x, y, w, 1, screen.foreground());
+        display.fillRect(x, y + h - 1, w, 1, screen.foreground());
+        display.fillRect(x, y + 1, 1, h - 2, screen.foreground());
+        display.fillRect(x + w - 1, y + 1, 1, h - 2, screen.foreground());
+        display.fillRect(x + 1, y + 1, fill, h - 2, screen.accent());
+        display.fillRect(x + 1 + fill, y + 1, inner - fill, h - 2, screen.background());
+    }
+    else if (fill > drawnFill)
+    {
+        display.fillRect(x + 1 + drawnFill, y + 1, fill - drawnFill, h - 2, screen.accent());
+    }
+    else if (fill < drawnFill)
+    {
+        display.fillRect(x + 1 + fill, y + 1, drawnFill - fill, h - 2, screen.background());
+    }
+    drawnFill = fill;
+}
+
+// VALUE EDITOR
+Epson_PNL_CE02_ValueEditor::Epson_PNL_CE02_ValueEditor(int16_t x, int16_t y, int16_t w, const char *pLabel,
+                                                       long minimum, long maximum, long step)
+    : Epson_PNL_CE02_Widget(x, y, w), label(pLabel), minimum(minimum), maximum(maximum), step(step), current(minimum)
+{
+    const byte lowest = numberColumns(minimum);
+    const byte highest = numberColumns(maximum);
+    valueColumns = lowest > highest ? lowest : highest;
+}
+
+void Epson_PNL_CE02_ValueEditor::setValue(long value)
+{
+    value = value < minimum ? minimum : (value > maximum ? maximum : value);
+    if (value != current)
+    {
+        current = value;
+        markChanged();
+    }
+}
+
+// cppcheck-suppress unusedFunction
+long Epson_PNL_CE02_ValueEditor::value() const
+{
+    return current;
+}
+
+bool Epson_PNL_CE02_ValueEditor::isFocusable() const
+{
+    return true;
+}
+
+void Epson_PNL_CE02_ValueEditor::draw(Epson_PNL_CE02_Screen &screen, bool focused, bool whole)
+{
+    Epson_PNL_CE02_Text &text = screen.text();
+    const uint16_t background = focused ? screen.accent() : screen.background();
+    const int16_t columns = w / text.charWidth();
+    const byte labelColumns = columns > valueColumns ? columns - valueColumns : 0;
+    text.setColors(screen.foreground(), background);
+    if (whole)
+    {
+        text.drawText(x, y, label, labelColumns);
+        fillRest(screen, x, y, w, background);
+    }
+    text.drawNumber(x + labelColumns * text.charWidth(), y, current, valueColumns);
+}
+
+bool Epson_PNL_CE02_ValueEditor::press(ButtonMask button)
+{
+    switch (button)
+    {
+    case ButtonMask::LEFT:
+        // Differences computed unsigned: the limits may be the whole range of long
+        setValue(static_cast<unsigned long>(current) - minimum >= static_cast<unsigned long>(step) ? current - step
+                                                                                                    : minimum);
+        return true;
+    case ButtonMask::RIGHT:
+        setValue(static_cast<unsigned long>(maximum) - current >= static_cast<unsigned long>(step) ? current + step
+                                                                                                    : maximum);
+        return true;
+    default:
+        return false;
+    }
+}
+
+// MENU
+Epson_PNL_CE02_Menu::Epson_PNL_CE02_Menu(int16_t x, int16_t y, int16_t w, byte rows, const char *const *pItems,
+                                         byte count)
+    : Epson_PNL_CE02_Widget(x, y, w), rows(rows), items(pItems), count(count)
+{
+}
+
+void Epson_PNL_CE02_Menu::setSelected(byte index)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    current = index < count ? index : count - 1;
+    if (current < top)
+    {
+        top = current;
+    }
+    else if (current >= top + rows)
+    {
+        top = current - rows + 1;
+    }
+    markChanged();
+}
+
+// cppcheck-suppress unusedFunction
+byte Epson_PNL_CE02_Menu::selected() const
+{
+    return current;
+}
+
+bool Epson_PNL_CE02_Menu::isFocusable() const
+{
+    return true;
+}
+
+void Epson_PNL_CE02_Menu::draw(Epson_PNL_CE02_Screen &screen, bool focused, bool whole)
+{
+    if (whole || top != drawnTop)
+    {
+        for (byte row = 0; row < rows; row++)
+        {
+            drawRow(screen, row, focused);
+        }
+    }
+    else if (current != drawnCurrent)
+    {
+        // Previous and new selections only
+        drawRow(screen, drawnCurrent - top, focused);
+        drawRow(screen, current - top, focused);
+    }
+    drawnTop = top;
+    drawnCurrent = current;
+}
+
+bool Epson_PNL_CE02_Menu::press(ButtonMask button)
+{
+    if (button == ButtonMask::UP && current > 0)
+    {
+        setSelected(current - 1);
+        return true;
+    }
+    if (button == ButtonMask::DOWN && current + 1 < count)
+    {
+        setSelected(current + 1);
+        return true;
+    }
+    return false;
+}
+
+void Epson_PNL_CE02_Menu::drawRow(Epson_PNL_CE02_Screen &screen, byte row, bool focused)
+{
+    Epson_PNL_CE02_Text &text = screen.text();
+    const byte item = top + row;
+    const uint16_t background = focused && item == current ? screen.accent() : screen.background();
+    const int16_t rowY = y + row * text.lineHeight();
+    const byte columns = w / text.charWidth();
+    text.setColors(screen.foreground(), background);
+    if (item < count)
+    {
+        text.drawText_P(x, rowY, static_cast<const char *>(pgm_read_ptr(items + item)), columns);
+    }
+    else
+    {
+        text.drawText(x, rowY, "", columns);
+    }
+    fillRest(screen, x, rowY, w, background);
+}
+
+// SCREEN
+Epson_PNL_CE02_Screen::Epson_PNL_CE02_Screen(Epson_PNL_CE02_Display *pDisplay, const Epson_PNL_CE02_Font *pFont)
+    : lcd(pDisplay), renderer(pDisplay, pFont)
+{
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Screen::setColors(uint16_t foreground, uint16_t background, uint16_t accent)
+{
+    foregroundColor = foreground;
+    backgroundColor = background;
+    accentColor = accent;
+    if (widgets != nullptr)
+    {
+        show(widgets, count);
+    }
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Screen::setHandler(Handler handler)
+{
+    this->handler = handler;
+}
+
+void Epson_PNL_CE02_Screen::show(Epson_PNL_CE02_Widget *const *pWidgets, byte count)
+{
+    widgets = pWidgets;
+    this->count = count;
+    lcd->fillRect(0, 0, Epson_PNL_CE02_Display::WIDTH, Epson_PNL_CE02_Display::HEIGHT, backgroundColor);
+    for (byte index = 0; index < count; index++)
+    {
+        widgets[index]->invalidate();
+    }
+    focusIndex = -1;
+    moveFocus(1);
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Screen::focus(Epson_PNL_CE02_Widget *pWidget)
+{
+    for (byte index = 0; index < count; index++)
+    {
+        if (widgets[index] == pWidget && pWidget->isFocusable())
+        {
+            if (focusIndex >= 0)
+            {
+                widgets[focusIndex]->invalidate();
+            }
+            focusIndex = static_cast<int8_t>(index);
+            pWidget->invalidate();
+            return;
+        }
+    }
+}
+
+Epson_PNL_CE02_Widget *Epson_PNL_CE02_Screen::focused() const
+{
+    return focusIndex >= 0 ? widgets[focusIndex] : nullptr;
+}
+
+void Epson_PNL_CE02_Screen::press(ButtonMask button)
+{
+    Epson_PNL_CE02_Widget *pFocused = focused();
+    if (pFocused != nullptr && pFocused->press(button))
+    {
+        return;
+    }
+    if ((button == ButtonMask::UP && moveFocus(-1)) || (button == ButtonMask::DOWN && moveFocus(1)))
+    {
+        return;
+    }
+    if (handler != nullptr)
+    {
+        handler(pFocused, button);
+    }
+}
+
+// cppcheck-suppress unusedFunction
+void Epson_PNL_CE02_Screen::pressButtons(uint16_t buttons)
+{
+    for (byte bit = 0; bit < BUTTONS; bit++)
+    {
+        if ((buttons & (1U << bit)) != 0)
+        {
+            press(static_cast<ButtonMask>(1U << bit));
+        }
+    }
+}
+
+byte Epson_PNL_CE02_Screen::update()
+{
+    byte repainted = 0;
+    for (byte index = 0; index < count; index++)
+    {
+        Epson_PNL_CE02_Widget *pWidget = widgets[index];
+        if (pWidget->dirty)
+        {
+            pWidget->draw(*this, index == focusIndex, pWidget->whole);
+            pWidget->dirty = false;
+            pWidget->whole = false;
+            repainted++;
+        }
+    }
+    return repainted;
+}
+
+Epson_PNL_CE02_Display &Epson_PNL_CE02_Screen::display()
+{
+    return *lcd;
+}
+
+Epson_PNL_CE02_Text &Epson_PNL_CE02_Screen::text()
+{
+    return renderer;
+}
+
+uint16_t Epson_PNL_CE02_Screen::foreground() const
+{
+    return foregroundColor;
+}
+
+uint16_t Epson_PNL_CE02_Screen::background() const
+{
+    return backgroundColor;
+}
+
+uint16_t Epson_PNL_CE02_Screen::accent() const
+{
+    return accentColor;
+}
+
+// PRIVATES
+bool Epson_PNL_CE02_Screen::moveFocus(int8_t direction)
+{
+    for (int16_t index = focusIndex + direction; index >= 0 && index < count; index += direction)
+    {
+        if (widgets[index]->isFocusable())
+        {
+            if (focusIndex >= 0)
+            {
+                widgets[focusIndex]->invalidate();
+            }
+            focusIndex = static_cast<int8_t>(index);
+            widgets[index]->invalidate();
+            return true;
+        }
+    }
+    return false;
+}
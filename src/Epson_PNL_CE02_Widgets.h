@@ -0,0 +1,353 @@
+/**
+ * @file Epson_PNL_CE02_Widgets.h
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Retained-mode widgets of the control panel (PNL CE02) of EPSON XP 520/530/540 printers.
+ *
+ * Widgets are static objects holding their state, shown by an Epson_PNL_CE02_Screen:
+ *  => a change only marks the widget as damaged, Epson_PNL_CE02_Screen::update() repaints damaged widgets
+ *  => a widget repaints only what changed since it was drawn (the value of an editor, two rows of a menu, the
+ *     difference of a progress bar), through Epson_PNL_CE02_Display and Epson_PNL_CE02_Text
+ *  => buttons move the focus between focusable widgets (UP / DOWN) and edit the focused widget (LEFT / RIGHT),
+ *     other buttons are given to the application (OK, HOME, STOP...)
+ *
+ * @version 1.0.1  # x-release-please-version
+ *
+ * @copyright MIT license
+ */
+
+#ifndef EPSON_PNL_CE02_WIDGETS_H
+#define EPSON_PNL_CE02_WIDGETS_H
+
+#include <Arduino.h>
+#include <Epson_PNL_CE02.h>
+#include <Epson_PNL_CE02_Display.h>
+#include <Epson_PNL_CE02_Font.h>
+#include <Epson_PNL_CE02_Text.h>
+
+class Epson_PNL_CE02_Screen;
+
+/**
+ * @brief Base of the widgets: a rectangle repainted when damaged.
+ * Derive it for custom widgets: call markChanged() when the state changes, repaint in draw().
+ */
+class Epson_PNL_CE02_Widget // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    /**
+     * @brief Construct a new Epson_PNL_CE02_Widget object, damaged.
+     *
+     * @param x left column
+     * @param y top row
+     * @param w width
+     */
+    Epson_PNL_CE02_Widget(int16_t x, int16_t y, int16_t w);
+
+    /**
+     * @brief Repaint the whole widget at the next Epson_PNL_CE02_Screen::update().
+     */
+    void invalidate();
+
+    /**
+     * @brief Determine if the widget waits for a repaint.
+     *
+     * @return true
+     * @return false
+     */
+    bool isDirty() const;
+
+    /**
+     * @brief Determine if the widget can receive the focus.
+     */
+    virtual bool isFocusable() const;
+
+    /**
+     * @brief Repaint the widget.
+     *
+     * @param screen painting context (display, text, colors)
+     * @param focused true if the widget has the focus
+     * @param whole true to repaint everything, false to repaint only what changed since the last draw()
+     */
+    virtual void draw(Epson_PNL_CE02_Screen &screen, bool focused, bool whole) = 0;
+
+    /**
+     * @brief Handle a button pressed while the widget has the focus.
+     *
+     * @return true if the button was used by the widget
+     */
+    virtual bool press(ButtonMask button);
+
+  protected:
+    int16_t x;
+    int16_t y;
+    int16_t w;
+
+    /**
+     * @brief Repaint what changed at the next Epson_PNL_CE02_Screen::update().
+     */
+    void markChanged();
+
+  private:
+    friend class Epson_PNL_CE02_Screen;
+    bool dirty = true;
+    bool whole = true;
+};
+
+/**
+ * @brief Line of text, padded to the width of the widget.
+ */
+class Epson_PNL_CE02_Label : public Epson_PNL_CE02_Widget // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    /**
+     * @brief Construct a new Epson_PNL_CE02_Label object.
+     *
+     * @param pText text, kept until replaced by setText()
+     */
+    Epson_PNL_CE02_Label(int16_t x, int16_t y, int16_t w, const char *pText = "");
+
+    /**
+     * @brief Change the text, also to call when the content of the text changed.
+     */
+    void setText(const char *pText);
+
+    void draw(Epson_PNL_CE02_Screen &screen, bool focused, bool whole) override;
+
+  private:
+    const char *text;
+};
+
+/**
+ * @brief Horizontal bar filled from the left, with a frame.
+ */
+class Epson_PNL_CE02_ProgressBar : public Epson_PNL_CE02_Widget // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    /**
+     * @brief Construct a new Epson_PNL_CE02_ProgressBar object, empty.
+     *
+     * @param h height, frame included
+     * @param maximum value of a full bar
+     */
+    Epson_PNL_CE02_ProgressBar(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t maximum = 100);
+
+    /**
+     * @brief Change the value, only the difference with the drawn bar is repainted.
+     *
+     * @param value 0 to maximum
+     */
+    void setValue(uint16_t value);
+
+    uint16_t value() const;
+
+    void draw(Epson_PNL_CE02_Screen &screen, bool focused, bool whole) override;
+
+  private:
+    int16_t h;
+    uint16_t maximum;
+    uint16_t current = 0;
+    int16_t drawnFill = 0; // filled columns on screen
+};
+
+/**
+ * @brief Label and number, changed by LEFT / RIGHT while focused. Only the number is repainted on change.
+ */
+class Epson_PNL_CE02_ValueEditor : public Epson_PNL_CE02_Widget // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    /**
+     * @brief Construct a new Epson_PNL_CE02_ValueEditor object, at the minimum.
+     *
+     * @param pLabel text at the left, kept
+     * @param minimum lowest value
+     * @param maximum highest value
+     * @param step change per press of LEFT / RIGHT
+     */
+    Epson_PNL_CE02_ValueEditor(int16_t x, int16_t y, int16_t w, const char *pLabel, long minimum, long maximum,
+                               long step = 1);
+
+    /**
+     * @brief Change the value, clamped to the limits.
+     */
+    void setValue(long value);
+
+    long value() const;
+
+    bool isFocusable() const override;
+    void draw(Epson_PNL_CE02_Screen &screen, bool focused, bool whole) override;
+    bool press(ButtonMask button) override;
+
+  private:
+    const char *label;
+    long minimum;
+    long maximum;
+    long step;
+    long current;
+    byte valueColumns;
+};
+
+/**
+ * @brief List of items, a row each, scrolled to keep the selected item visible.
+ * Moving the selection repaints the two rows changed, unless the list scrolls.
+ */
+class Epson_PNL_CE02_Menu : public Epson_PNL_CE02_Widget // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    /**
+     * @brief Construct a new Epson_PNL_CE02_Menu object, the first item selected.
+     *
+     * @param rows visible rows
+     * @param pItems table of items in PROGMEM, texts in PROGMEM
+     * @param count number of items
+     */
+    Epson_PNL_CE02_Menu(int16_t x, int16_t y, int16_t w, byte rows, const char *const *pItems, byte count);
+
+    /**
+     * @brief Select an item, scrolled into view.
+     */
+    void setSelected(byte index);
+
+    byte selected() const;
+
+    bool isFocusable() const override;
+    void draw(Epson_PNL_CE02_Screen &screen, bool focused, bool whole) override;
+
+    /**
+     * @brief UP / DOWN move the selection, except beyond the first and last items: the focus moves instead.
+     */
+    bool press(ButtonMask button) override;
+
+  private:
+    byte rows;
+    const char *const *items;
+    byte count;
+    byte current = 0;
+    byte top = 0;          // first visible item
+    byte drawnTop = 0;     // first visible item on screen
+    byte drawnCurrent = 0; // selected item on screen
+
+    void drawRow(Epson_PNL_CE02_Screen &screen, byte row, bool focused);
+};
+
+/**
+ * @brief Set of widgets shown together, with the focus, the navigation and the repaint of damaged widgets.
+ *
+ * @example
+ * ``` c++
+ * const char ITEM_COPY[] PROGMEM = "Copy";
+ * const char ITEM_SCAN[] PROGMEM = "Scan";
+ * const char *const ITEMS[] PROGMEM = {ITEM_COPY, ITEM_SCAN};
+ *
+ * Epson_PNL_CE02_Label title(0, 0, 128, "Main menu");
+ * Epson_PNL_CE02_Menu menu(0, 12, 128, 4, ITEMS, 2);
+ * Epson_PNL_CE02_Widget *const WIDGETS[] = {&title, &menu};
+ *
+ * Epson_PNL_CE02_Screen screen(&display);
+ * screen.show(WIDGETS, 2);
+ *
+ * void loop() {
+ *     screen.pressButtons(gestures.justPressed()); // navigation
+ *     screen.update();                            // repaint what changed
+ * }
+ * ```
+ */
+class Epson_PNL_CE02_Screen // NOLINT(readability-identifier-naming): Exception to follow common Arduino Library style naming
+{
+
+  public:
+    /**
+     * @brief Buttons not used by the navigation nor by the focused widget.
+     *
+     * @param pFocused focused widget, nullptr if none
+     * @param button pressed button
+     */
+    using Handler = void (*)(Epson_PNL_CE02_Widget *pFocused, ButtonMask button);
+
+    /**
+     * @brief Construct a new Epson_PNL_CE02_Screen object, white on black with a blue focus.
+     *
+     * @param pDisplay Reference to the display receiving the widgets.
+     * @param pFont font of the widgets (default: EPSON_PNL_CE02_FONT_6X8)
+     */
+    explicit Epson_PNL_CE02_Screen(Epson_PNL_CE02_Display *pDisplay,
+                                   const Epson_PNL_CE02_Font *pFont = &EPSON_PNL_CE02_FONT_6X8);
+
+    /**
+     * @brief Set the colors of the widgets, then repaint them.
+     *
+     * @param foreground RGB565 color of texts and frames
+     * @param background RGB565 color of the screen
+     * @param accent RGB565 color of the focus and of progress bars
+     */
+    void setColors(uint16_t foreground, uint16_t background, uint16_t accent);
+
+    void setHandler(Handler handler);
+
+    /**
+     * @brief Show widgets: the screen is cleared, every widget is damaged and the first focusable widget focused.
+     *
+     * @param pWidgets widgets, the table is kept
+     * @param count number of widgets
+     */
+    void show(Epson_PNL_CE02_Widget *const *pWidgets, byte count);
+
+    /**
+     * @brief Give the focus to a focusable widget of the screen.
+     */
+    void focus(Epson_PNL_CE02_Widget *pWidget);
+
+    /**
+     * @brief Focused widget, nullptr if none.
+     */
+    Epson_PNL_CE02_Widget *focused() const;
+
+    /**
+     * @brief Handle a pressed button: the focused widget first, then UP / DOWN move the focus, then the handler.
+     */
+    void press(ButtonMask button);
+
+    /**
+     * @brief Handle pressed buttons, refer to press().
+     *
+     * @param buttons ButtonMask bits, e.g. Epson_PNL_CE02_Gestures::justPressed()
+     */
+    void pressButtons(uint16_t buttons);
+
+    /**
+     * @brief Repaint damaged widgets.
+     *
+     * @return byte number of widgets repainted
+     */
+    byte update();
+
+    // Painting context of the widgets
+    Epson_PNL_CE02_Display &display();
+    Epson_PNL_CE02_Text &text();
+    uint16_t foreground() const;
+    uint16_t background() const;
+    uint16_t accent() const;
+
+  private:
+    Epson_PNL_CE02_Display *lcd;
+    Epson_PNL_CE02_Text renderer;
+    uint16_t foregroundColor = 0xFFFF;
+    uint16_t backgroundColor = 0x0000;
+    uint16_t accentColor = 0x001F;
+    Handler handler = nullptr;
+    Epson_PNL_CE02_Widget *const *widgets = nullptr;
+    byte count = 0;
+    int8_t focusIndex = -1;
+
+    /**
+     * @brief Move the focus to the next focusable widget in a direction.
+     *
+     * @return true if the focus moved
+     */
+    bool moveFocus(int8_t direction);
+};
+
+#endif // EPSON_PNL_CE02_WIDGETS_H
@@ -0,0 +1,531 @@
+/**
+ * @file test_simulator.cpp
+ * @author Xavier BRASSOUD (contact@xavierbrassoud.fr)
+ * @brief Regression tests of the library against the PNL CE02 simulator (refer to extras/simulator).
+ *
+ * Bus counters and panel snapshots are compared with the references committed in `reference/`:
+ *  => counters.txt: one `Counters::print()` line per measured operation
+ *  => <name>.ppm: panel content, refer to `DisplayController::writeSnapshot()`
+ *
+ * Run with: pio test -e native_test
+ * After an intended change, review then commit the references written by: PNL_TEST_UPDATE=1 pio test -e native_test
+ *
+ * @copyright MIT license
+ */
+
+#include <Arduino.h>
+#include <Epson_PNL_CE02.h>
+#include <Epson_PNL_CE02_Console.h>
+#include <Epson_PNL_CE02_Display.h>
+#include <Epson_PNL_CE02_Remote.h>
+#include <Epson_PNL_CE02_Simulator.h>
+#include <Epson_PNL_CE02_Sprites.h>
+#include <unity.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifndef PNL_TEST_REFERENCE_DIR
+#define PNL_TEST_REFERENCE_DIR "test/test_simulator/reference" // pio test runs from the project directory
+#endif
+
+namespace
+{
+Epson_PNL_CE02_Pinout pinout = {
+    /* Control panel to Arduino pinout */
+    .EXTENDER_OE = 45,  // FFC 1
+    .SERIAL_OUT = 50,   // SPI MISO / FFC 2
+    .POWER_BUTTON = 46, // FFC 4
+    .LCD_RESET = 47,    // FFC 6
+    .CLOCK = 52,        // SPI SCK / FFC 9
+    .SERIAL_IN = 51,    // SPI MOSI / FFC 10
+    .LATCH = 48,        // FFC 11
+    .LCD_WRITE = 49,    // FFC 13
+};
+
+Epson_PNL_CE02 controlPanel(&pinout);
+Epson_PNL_CE02_Display display(&controlPanel);
+
+const char *const COUNTERS_PATH = PNL_TEST_REFERENCE_DIR "/counters.txt";
+bool updating = false;
+std::map<std::string, std::string> references; // label => counters line
+
+void loadReferences()
+{
+    FILE *pFile = fopen(COUNTERS_PATH, "r");
+    if (pFile == nullptr)
+    {
+        return;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), pFile) != nullptr)
+    {
+        const char *pSpace = strchr(line, ' ');
+        if (pSpace != nullptr)
+        {
+            references[std::string(line, pSpace - line)] = line;
+        }
+    }
+    fclose(pFile);
+}
+
+bool saveReferences()
+{
+    FILE *pFile = fopen(COUNTERS_PATH, "w");
+    if (pFile == nullptr)
+    {
+        return false;
+    }
+    for (const auto &reference : references)
+    {
+        fputs(reference.second.c_str(), pFile);
+    }
+    return fclose(pFile) == 0;
+}
+
+/**
+ * @brief Line printed by Counters::print().
+ */
+std::string format(const simulator::Counters &counters, const char *pLabel)
+{
+    FILE *pFile = tmpfile();
+    TEST_ASSERT_NOT_NULL(pFile);
+    counters.print(pFile, pLabel);
+    rewind(pFile);
+    char line[256] = "";
+    TEST_ASSERT_NOT_NULL(fgets(line, sizeof(line), pFile));
+    fclose(pFile);
+    return line;
+}
+
+void expectCounters(const char *pLabel, const simulator::Counters &counters)
+{
+    const std::string line = format(counters, pLabel);
+    if (updating)
+    {
+        references[pLabel] = line;
+        return;
+    }
+    const auto reference = references.find(pLabel);
+    TEST_ASSERT_TRUE_MESSAGE(reference != references.end(), pLabel);
+    TEST_ASSERT_EQUAL_STRING(reference->second.c_str(), line.c_str());
+}
+
+void expectSnapshot(const char *pName)
+{
+    const std::string path = std::string(PNL_TEST_REFERENCE_DIR "/") + pName + ".ppm";
+    if (updating)
+    {
+        TEST_ASSERT_TRUE_MESSAGE(simulator::board().display.writeSnapshot(path.c_str()), path.c_str());
+        return;
+    }
+    TEST_ASSERT_TRUE_MESSAGE(simulator::board().display.matchesSnapshot(path.c_str()), path.c_str());
+}
+
+uint16_t pixel(int x, int y)
+{
+    return simulator::board().display.pixel(x, y);
+}
+
+// 8x4 image, 4 colors: a run of 10, 6 literal pixels, then a long run of 16
+const byte IMAGE[] PROGMEM = {
+    0xCE, 8,    4,    3,                         // FORMAT, width, height, colors - 1
+    0xF8, 0x00, 0x07, 0xE0, 0x00, 0x1F, 0xFF, 0xFF, // red, green, blue, white
+    0x89, 0x01,                                     // run of 10 green
+    0x05, 0x1B, 0x10,                               // 6 literals: red, green, blue, white, red, green
+    0xC0, 0x0F, 0x02,                               // long run of 16 blue
+};
+const uint16_t IMAGE_PALETTE[] = {0xF800, 0x07E0, 0x001F, 0xFFFF};
+const byte IMAGE_INDEXES[8 * 4] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 2, 3, 0, 1,
+                                   2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2};
+
+const byte TILE_SIZE = 8;
+uint16_t tiles[3 * TILE_SIZE * TILE_SIZE] PROGMEM;
+byte tileMap[10 * 9] PROGMEM;
+const Epson_PNL_CE02_Tilemap TILEMAP = {tiles, tileMap, TILE_SIZE, 10, 9};
+const uint16_t TRANSPARENT = 0xF81F;
+uint16_t ball[9 * 7] PROGMEM;
+
+/**
+ * @brief Serial link to the host: bytes queued by the test, frames sent by the panel kept.
+ */
+class HostStream : public Stream
+{
+  public:
+    std::deque<byte> input;
+    std::vector<byte> output;
+
+    int available() override
+    {
+        return static_cast<int>(input.size());
+    }
+    int read() override
+    {
+        if (input.empty())
+        {
+            return -1;
+        }
+        const byte value = input.front();
+        input.pop_front();
+        return value;
+    }
+    int peek() override
+    {
+        return input.empty() ? -1 : input.front();
+    }
+    size_t write(uint8_t value) override
+    {
+        output.push_back(value);
+        return 1;
+    }
+};
+
+struct Frame
+{
+    byte command;
+    std::vector<byte> payload;
+};
+
+byte crc8(byte crc, byte value)
+{
+    crc ^= value;
+    for (byte bit = 0; bit < 8; bit++)
+    {
+        crc = (crc & 0x80) != 0 ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+    return crc;
+}
+
+/**
+ * @brief Queue a frame sent by the host, refer to Epson_PNL_CE02_Remote.h.
+ */
+void sendFrame(HostStream &stream, byte command, std::initializer_list<byte> payload, bool corrupt = false)
+{
+    const byte header[] = {command, static_cast<byte>(payload.size()), static_cast<byte>(payload.size() >> 8)};
+    byte crc = 0;
+    stream.input.push_back(0xA5);
+    for (const byte value : header)
+    {
+        stream.input.push_back(value);
+        crc = crc8(crc, value);
+    }
+    for (const byte value : payload)
+    {
+        stream.input.push_back(value);
+        crc = crc8(crc, value);
+    }
+    stream.input.push_back(corrupt ? crc ^ 0xFF : crc);
+}
+
+/**
+ * @brief Frames sent by the panel, CRC checked.
+ */
+std::vector<Frame> receivedFrames(const HostStream &stream)
+{
+    std::vector<Frame> frames;
+    size_t index = 0;
+    while (index + 5 <= stream.output.size())
+    {
+        TEST_ASSERT_EQUAL_HEX8(0xA5, stream.output[index]);
+        const uint16_t size = stream.output[index + 2] | (stream.output[index + 3] << 8);
+        TEST_ASSERT_TRUE(index + 5 + size <= stream.output.size());
+        byte crc = 0;
+        for (size_t position = index + 1; position < index + 4 + size; position++)
+        {
+            crc = crc8(crc, stream.output[position]);
+        }
+        TEST_ASSERT_EQUAL_HEX8(crc, stream.output[index + 4 + size]);
+        frames.push_back({stream.output[index + 1], std::vector<byte>(stream.output.begin() + index + 4,
+                                                                         stream.output.begin() + index + 4 + size)});
+        index += 5 + size;
+    }
+    TEST_ASSERT_EQUAL_UINT32(stream.output.size(), index);
+    return frames;
+}
+} // namespace
+
+void setUp()
+{
+    display.begin(); // black screen, window cache invalidated
+}
+
+void tearDown()
+{
+}
+
+// Pixels drawn one by one along a row continue the same RAMWR burst
+void testWindowCaching()
+{
+    const uint32_t saved = display.savedCommandBytes();
+    const simulator::Counters row = simulator::measure([] {
+        for (int16_t x = 8; x < 72; x++)
+        {
+            display.drawPixel(x, 5, 0xFFFF);
+        }
+    });
+    expectCounters("window_row", row);
+    TEST_ASSERT_EQUAL_UINT32(3, row.displayCommands); // CASET, RASET, RAMWR once
+    TEST_ASSERT_TRUE(display.savedCommandBytes() > saved);
+
+    // Same columns, another row: CASET skipped
+    const simulator::Counters column = simulator::measure([] { display.fillRect(8, 20, 120, 1, 0x07E0); });
+    expectCounters("window_same_columns", column);
+    TEST_ASSERT_EQUAL_UINT32(2, column.displayCommands); // RASET, RAMWR
+
+    TEST_ASSERT_EQUAL_HEX16(0x0000, pixel(7, 5));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, pixel(71, 5));
+    TEST_ASSERT_EQUAL_HEX16(0x0000, pixel(72, 5));
+    TEST_ASSERT_EQUAL_HEX16(0x07E0, pixel(127, 20));
+}
+
+// Two pixels per 3 bytes, odd counts padded without shifting the next pixels
+void testRGB444Pairing()
+{
+    static uint16_t frame[128 * 128];
+    for (uint16_t i = 0; i < 128 * 128; i++)
+    {
+        frame[i] = Epson_PNL_CE02_Display::color565((i % 128) * 2, (i / 128) * 2, 128);
+    }
+    display.setColorMode(ColorMode::RGB444);
+    const simulator::Counters full = simulator::measure([] {
+        display.setWindow(0, 0, 127, 127);
+        display.writePixels(frame, 128UL * 128);
+    });
+    expectCounters("rgb444_frame", full);
+    TEST_ASSERT_EQUAL_UINT32(128UL * 128 * 3 / 2, full.displayData);
+
+    display.fillRect(0, 0, 3, 1, 0xF800);
+    display.drawPixel(3, 0, 0x001F);
+    TEST_ASSERT_EQUAL_HEX16(0xF800, pixel(0, 0));
+    TEST_ASSERT_EQUAL_HEX16(0xF800, pixel(2, 0));
+    TEST_ASSERT_EQUAL_HEX16(0x001F, pixel(3, 0));
+    expectSnapshot("rgb444");
+}
+
+// Runs sent as fills, literals through the palette, a single window
+void testImageDecode()
+{
+    bool drawn = false;
+    const simulator::Counters image = simulator::measure([&drawn] { drawn = display.drawImage_P(60, 62, IMAGE); });
+    TEST_ASSERT_TRUE(drawn);
+    expectCounters("image_rle", image);
+    TEST_ASSERT_EQUAL_UINT32(3, image.displayCommands);
+
+    for (int i = 0; i < 8 * 4; i++)
+    {
+        TEST_ASSERT_EQUAL_HEX16(IMAGE_PALETTE[IMAGE_INDEXES[i]], pixel(60 + i % 8, 62 + i / 8));
+    }
+    TEST_ASSERT_FALSE(display.drawImage_P(124, 0, IMAGE)); // not fully on screen
+    expectSnapshot("image");
+}
+
+// Lines scrolled by the display between a fixed header and footer
+void testConsoleScroll()
+{
+    Epson_PNL_CE02_Console console(&display);
+    display.fillRect(0, 0, 128, 128, 0x001F);
+    console.begin(10, 8);
+    TEST_ASSERT_EQUAL_UINT8(21, console.columns());
+    TEST_ASSERT_EQUAL_UINT8(13, console.rows());
+
+    char line[32];
+    for (int i = 0; i < 20; i++)
+    {
+        snprintf(line, sizeof(line), "line %d: value=%d", i, i * 37);
+        console.println(line);
+    }
+    const simulator::Counters scroll = simulator::measure([&console] { console.println("scrolled"); });
+    expectCounters("console_scroll", scroll);
+    console.print("0123456789abcdefghijklmnopqrstuvwxyz"); // wrapped
+
+    TEST_ASSERT_EQUAL_HEX16(0x001F, pixel(0, 0));   // header
+    TEST_ASSERT_EQUAL_HEX16(0x001F, pixel(0, 127)); // footer
+    expectSnapshot("console");
+    console.end();
+}
+
+/**
+ * @brief Determine if a row of the panel shows glyphs, white on black.
+ */
+bool hasText(int y)
+{
+    for (int x = 0; x < 128; x++)
+    {
+        if (pixel(x, y) != 0x0000)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// A full line ended by println() scrolls by one line only, no blank line
+void testConsoleWrap()
+{
+    Epson_PNL_CE02_Console console(&display);
+    console.begin();
+    TEST_ASSERT_EQUAL_UINT8(16, console.rows());
+    for (int i = 0; i < 16; i++)
+    {
+        console.print("line ");
+        console.println(i);
+    }
+    const simulator::Counters full = simulator::measure([&console] { console.println("0123456789abcdefghijk"); });
+    expectCounters("console_full_line", full);
+    console.print("more");
+
+    TEST_ASSERT_TRUE(hasText(14 * 8 + 3)); // the full line, just above
+    TEST_ASSERT_TRUE(hasText(15 * 8 + 3)); // "more", on the last line
+    expectSnapshot("console_wrap");
+    console.end();
+}
+
+// Frames from the host: pixels decoded as they arrive, errors reported, credits granted for every byte read
+void testRemote()
+{
+    const byte FILL = 0x10, RECT = 0x11;                 // host to panel
+    const byte INFO = 0x81, CREDIT = 0x82, ERROR = 0x84; // panel to host
+    const byte ERROR_CRC = 1, ERROR_PAYLOAD = 3;         // ERROR codes
+    const uint16_t CREDIT_STEP = Epson_PNL_CE02_Remote::WINDOW / 4;
+    const byte RED_L = 0x00, RED_H = 0xF8, GREEN_L = 0xE0, GREEN_H = 0x07, BLUE_L = 0x1F, BLUE_H = 0x00; // RGB565
+
+    HostStream stream;
+    Epson_PNL_CE02_Remote remote(&controlPanel, &display, &stream);
+    remote.begin();
+    size_t sent = 0;
+
+    // 5x3: run of 10 green, 5 literal pixels
+    sendFrame(stream, FILL, {10, 10, 20, 20, RED_L, RED_H});
+    sendFrame(stream, RECT, {40, 40, 5, 3, 0x80 + 9, GREEN_L, GREEN_H, 4, RED_L, RED_H, BLUE_L, BLUE_H, 0xFF, 0xFF,
+                             RED_L, RED_H, BLUE_L, BLUE_H});
+    sent += stream.input.size();
+    remote.update();
+
+    // RGB444: a long run after an odd number of literal pixels keeps the pairs aligned
+    display.setColorMode(ColorMode::RGB444);
+    sendFrame(stream, RECT, {40, 50, 6, 3, 2, RED_L, RED_H, BLUE_L, BLUE_H, RED_L, RED_H, 0x80 + 8, GREEN_L,
+                             GREEN_H, 5, BLUE_L, BLUE_H, 0xFF, 0xFF, BLUE_L, BLUE_H, 0xFF, 0xFF, BLUE_L, BLUE_H,
+                             0xFF, 0xFF});
+    sent += stream.input.size();
+    remote.update();
+    display.setColorMode(ColorMode::RGB565);
+
+    // Corrupted CRC, then noise before the next frame
+    sendFrame(stream, FILL, {70, 10, 8, 8, BLUE_L, BLUE_H}, true);
+    stream.input.push_back(0x00);
+    stream.input.push_back(0x13);
+    sendFrame(stream, FILL, {80, 10, 8, 8, GREEN_L, GREEN_H});
+    // 2x2 with a run of 6: decoding stops at the overrun, the frame is rejected
+    sendFrame(stream, RECT, {90, 40, 2, 2, 0x80 + 5, BLUE_L, BLUE_H});
+    sent += stream.input.size();
+    remote.update();
+    TEST_ASSERT_EQUAL_UINT32(0, stream.input.size());
+
+    TEST_ASSERT_EQUAL_UINT16(2, remote.errors());
+    const std::vector<Frame> frames = receivedFrames(stream);
+    TEST_ASSERT_TRUE(frames.size() > 0);
+    TEST_ASSERT_EQUAL_HEX8(INFO, frames[0].command);
+    std::vector<Frame> errors;
+    uint32_t credits = 0;
+    for (const Frame &frame : frames)
+    {
+        if (frame.command == ERROR)
+        {
+            errors.push_back(frame);
+        }
+        else if (frame.command == CREDIT)
+        {
+            const uint16_t credit = frame.payload[0] | (frame.payload[1] << 8);
+            TEST_ASSERT_EQUAL_UINT16(CREDIT_STEP, credit);
+            credits += credit;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, errors.size());
+    TEST_ASSERT_EQUAL_HEX8(ERROR_CRC, errors[0].payload[0]);
+    TEST_ASSERT_EQUAL_HEX8(FILL, errors[0].payload[1]);
+    TEST_ASSERT_EQUAL_HEX8(ERROR_PAYLOAD, errors[1].payload[0]);
+    TEST_ASSERT_EQUAL_HEX8(RECT, errors[1].payload[1]);
+    TEST_ASSERT_EQUAL_UINT32(sent - sent % CREDIT_STEP, credits); // every byte read, the rest with the next CREDIT
+
+    TEST_ASSERT_EQUAL_HEX16(0xF800, pixel(10, 10));
+    TEST_ASSERT_EQUAL_HEX16(0x07E0, pixel(44, 41));  // end of the run
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, pixel(42, 42));  // literal
+    TEST_ASSERT_EQUAL_HEX16(0xF800, pixel(42, 50));  // RGB444 literal
+    TEST_ASSERT_EQUAL_HEX16(0x07E0, pixel(45, 51));  // RGB444 run
+    TEST_ASSERT_EQUAL_HEX16(0x001F, pixel(44, 52));  // RGB444 literal after the run
+    TEST_ASSERT_EQUAL_HEX16(0x0000, pixel(70, 10));  // corrupted FILL
+    TEST_ASSERT_EQUAL_HEX16(0x07E0, pixel(80, 10));  // resynchronized
+    expectSnapshot("remote");
+}
+
+// Sprites over a tilemap, repainted where they moved
+void testSprites()
+{
+    for (int i = 0; i < 3 * TILE_SIZE * TILE_SIZE; i++)
+    {
+        tiles[i] = static_cast<uint16_t>(i * 389 + 7);
+    }
+    for (int i = 0; i < 10 * 9; i++)
+    {
+        tileMap[i] = static_cast<byte>((i * 7) % 3);
+    }
+    for (int i = 0; i < 9 * 7; i++)
+    {
+        ball[i] = i % 4 == 0 ? TRANSPARENT : static_cast<uint16_t>(0xF000 + i);
+    }
+
+    Epson_PNL_CE02_Sprites sprites(&display);
+    sprites.setBackground(0x1234);
+    sprites.setBackground(&TILEMAP);
+    sprites.setBitmap(0, ball, 9, 7, TRANSPARENT);
+    sprites.moveTo(0, 10, 10);
+    sprites.drawAll();
+
+    sprites.moveTo(0, 76, 70); // across the tilemap edge
+    uint32_t pixels = 0;
+    const simulator::Counters move = simulator::measure([&sprites, &pixels] { pixels = sprites.update(); });
+    expectCounters("sprites_move", move);
+    TEST_ASSERT_TRUE(pixels > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, sprites.update()); // nothing moved
+    TEST_ASSERT_EQUAL_HEX16(tiles[(tileMap[11] * TILE_SIZE + 2) * TILE_SIZE + 2], pixel(10, 10)); // transparent
+    TEST_ASSERT_EQUAL_HEX16(ball[1], pixel(77, 70));
+    TEST_ASSERT_EQUAL_HEX16(0x1234, pixel(100, 100));
+
+    // Right of the tilemap: the background color only, no tile read past the map
+    sprites.moveTo(0, 100, 64); // last row of tiles
+    sprites.update();
+    sprites.moveTo(0, 104, 64);
+    sprites.update();
+    TEST_ASSERT_EQUAL_HEX16(0x1234, pixel(101, 64));
+    TEST_ASSERT_EQUAL_HEX16(ball[1], pixel(105, 64));
+    expectSnapshot("sprites");
+}
+
+int main()
+{
+    controlPanel.begin();
+    updating = getenv("PNL_TEST_UPDATE") != nullptr;
+    loadReferences();
+
+    UNITY_BEGIN();
+    RUN_TEST(testWindowCaching);
+    RUN_TEST(testRGB444Pairing);
+    RUN_TEST(testImageDecode);
+    RUN_TEST(testConsoleScroll);
+    RUN_TEST(testConsoleWrap);
+    RUN_TEST(testRemote);
+    RUN_TEST(testSprites);
+    const int failures = UNITY_END();
+
+    if (updating && !saveReferences())
+    {
+        fprintf(stderr, "cannot write %s\n", COUNTERS_PATH);
+        return 1;
+    }
+    return failures;
+}